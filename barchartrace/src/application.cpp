@@ -74,29 +74,38 @@ int Application::run()
     Timer::FloatMS timePerCategory{args.getInt("-timepercategory", 2000)};
 
     // Use the arguments above to create the barchart class
-    BarChart barChart(fileName, timePerCategory, barHeight);
+    BarChart barChart(fileName, CsvOptions::fromArguments(args),
+                      timePerCategory, barHeight);
 
     // Load the provided font file
     const std::string& fontName = args.get("-font");
     if (fontName == Arguments::NotSet)
         throw std::runtime_error("Font file not provided");
-    fontRenderer.loadFont(fontName, barHeight * 0.36);
-    fontRendererLarge.loadFont(fontName, barHeight * 0.6);
+    GlyphMode fontMode = glyphModeFromArguments(args);
+    fontRenderer.loadFont(fontName, barHeight * 0.36, fontMode);
+    fontRendererLarge.loadFont(fontName, barHeight * 0.6, fontMode);
 
     // Update spacings
-    Spacings.beforeBars =
-        Paddings.aroundRowName +
-        fontRenderer.getWidthOfMsg(barChart.getLongestRowName());
     Spacings.aboveBars =
         Paddings.aroundTitle + fontRendererLarge.getFontHeight();
     Spacings.belowBars = Paddings.aroundControl + fontRenderer.getFontHeight();
 
-    Spacings.beforeControl =
-        Paddings.aroundControl +
-        fontRenderer.getWidthOfMsg(barChart.getCategories().front());
-    Spacings.afterControl =
-        Paddings.aroundControl +
-        fontRenderer.getWidthOfMsg(barChart.getCategories().back());
+    // These depend on the rows and categories, which can change if the CSV
+    // file is being followed
+    auto updateSpacings = [&]()
+    {
+        Spacings.beforeBars =
+            Paddings.aroundRowName +
+            fontRenderer.getWidthOfMsg(barChart.getLongestRowName());
+
+        Spacings.beforeControl =
+            Paddings.aroundControl +
+            fontRenderer.getWidthOfMsg(barChart.getCategories().front());
+        Spacings.afterControl =
+            Paddings.aroundControl +
+            fontRenderer.getWidthOfMsg(barChart.getCategories().back());
+    };
+    updateSpacings();
 
     // Start the timer and start drawing
     timer.start();
@@ -110,9 +119,17 @@ int Application::run()
 
         auto currentTime = timer.getInMilliseconds();
 
+        // 0 - Take in anything added to the CSV file, if following it
+        if (barChart.followFile())
+            updateSpacings();
+
         // 1 - Update bar chart values based on the current time, and the height
-        // of each bar based on the space to leave above the bars respectively
-        barChart.update(currentTime, Spacings.aboveBars);
+        // of each bar based on the space to leave above the bars respectively.
+        // Only as many bars as fit between the spacings are drawn
+        int spaceForBars =
+            gui.height - int(Spacings.aboveBars + Spacings.belowBars);
+        int barsShown = std::max(spaceForBars / int(barHeight + 10) + 1, 1);
+        barChart.update(currentTime, Spacings.aboveBars, barsShown);
 
         // 2 - Draw title and category
         fontRendererLarge.drawMsg(Paddings.aroundTitle,
@@ -162,41 +179,61 @@ int Application::run()
                  (lineValue / highestValue)) +
                 Spacings.beforeBars;
 
-            renderer.drawBox(lineX, Spacings.aboveBars - 10, lineX + 2,
-                             gui.height - Spacings.belowBars,
-                             Color{0, 0, 0, 0.3}, proj);
+            renderer.queueBox(lineX, Spacings.aboveBars - 10, lineX + 2,
+                              gui.height - Spacings.belowBars,
+                              Color{0, 0, 0, 0.3});
         }
 
         // 5 - draw the rows and their surrounding text
+        // Get the position of the end of the bar
+        auto getBarX2 = [&](const BarChart::RowState& row) -> float
+        {
+            return ((gui.width - Spacings.afterBars - Spacings.beforeBars) *
+                    (row.value / highestValue)) +
+                   Spacings.beforeBars;
+        };
+        auto isShown = [&](const BarChart::RowState& row)
+        {
+            return row.currentHeight + barHeight <
+                   (gui.height - Spacings.belowBars);
+        };
+
+        // Draw the bars as a proportion of the largest bar, all at once along
+        // with the lines behind them
+        for (std::size_t r : barChart.getRanking())
+        {
+            const BarChart::RowState& row = barChart.getRowStates()[r];
+            if (isShown(row))
+                renderer.queueBox(Spacings.beforeBars, row.currentHeight,
+                                  getBarX2(row), row.currentHeight + barHeight,
+                                  row.color);
+        }
+        renderer.flush(proj);
+
         // Used below to make the font draw in the middle of the bar
         long fontHeightSpacing = (barHeight - fontRenderer.getFontHeight()) / 2;
-        for (auto& row : barChart.getRowStates())
+        for (std::size_t r : barChart.getRanking())
         {
-            if (row.currentHeight + barHeight <
-                (gui.height - Spacings.belowBars))
+            const BarChart::RowState& row = barChart.getRowStates()[r];
+            if (isShown(row))
             {
-                // Get the position of the end of the bar
-                float barX2 =
-                    ((gui.width - Spacings.afterBars - Spacings.beforeBars) *
-                     (row.value / highestValue)) +
-                    Spacings.beforeBars;
-
-                // Draw the bar as a proportion of the largest bar
-                renderer.drawBox(Spacings.beforeBars, row.currentHeight, barX2,
-                                 row.currentHeight + barHeight, row.color,
-                                 proj);
-                // Draw in its title
-                fontRenderer.drawMsg(
-                    Spacings.beforeBars - (Paddings.aroundRowName * 0.3) -
-                        fontRenderer.getWidthOfMsg(row.name),
-                    row.currentHeight + fontHeightSpacing, row.name, proj);
+                float barX2 = getBarX2(row);
+                // Draw in its title, laid out once for both
+                const FontRenderer::TextRun& name =
+                    fontRenderer.getTextRun(row.name);
+                fontRenderer.queueRun(Spacings.beforeBars -
+                                          (Paddings.aroundRowName * 0.3) -
+                                          name.getWidth(),
+                                      row.currentHeight + fontHeightSpacing,
+                                      name);
                 // Draw in the current values
-                fontRenderer.drawLongDouble(
+                fontRenderer.queueLongDouble(
                     barX2 + (Paddings.aroundRowValue * 0.3),
                     row.currentHeight + fontHeightSpacing, row.value,
-                    numOfDecimalPlaces, proj);
+                    numOfDecimalPlaces);
             }
         }
+        fontRenderer.flush(proj);
 
         // 6 - Draw time control
         float controlX2 = gui.width - Spacings.afterControl;
@@ -258,6 +295,7 @@ int Application::run()
 
         // Advance to the next frame
         gui.nextFrame();
+        FontRenderer::endFrame();
     }
     return 0;
 }
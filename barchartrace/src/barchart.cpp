@@ -3,97 +3,263 @@
 #include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <unordered_map>
 
-// Helper function to generate colors for each row
-static void generateColors(std::vector<BarChart::RowState>& rows)
+#include "viszbase/ranking.hpp"
+
+// Helper function to generate colors for 'count' rows, spread out evenly
+// over the range of colors. There may be fewer than 'count' of them, in
+// which case the rows left over keep the color they have
+static std::vector<Color> generateColors(std::size_t count)
 {
-    int i = 0;
-    int increment = 3 * (255.0 / rows.size());
+    std::vector<Color> colors;
+    int increment = 3 * (255.0 / count);
     for (int r = 0; r <= 255; r += increment)
         for (int g = 0; g <= 255; g += increment)
             for (int b = 0; b <= 255; b += increment)
             {
-                if (i < rows.size())
-                    rows[i].color =
-                        Color{r / 255.0f, g / 255.0f, b / 255.0f, 1.0f};
-                else
-                    return;
-                ++i;
+                if (colors.size() >= count)
+                    return colors;
+                colors.push_back(
+                    Color{r / 255.0f, g / 255.0f, b / 255.0f, 1.0f});
             }
+    return colors;
+}
+
+// How far down the timeline ranks rows, compared to the number of bars
+// shown. It's built deeper than needed, so it doesn't need building again
+// every time the window grows a little, and so bars leaving the ranking have
+// already gone off the bottom
+constexpr std::size_t TimelineDepthFactor = 2;
+constexpr std::size_t MinTimelineDepth = 64;
+
+// With fewer rows than this for each thread, spreading an update over
+// threads costs more than it saves
+constexpr std::size_t MinRowsPerThread = 1 << 16;
+
+// The bars are updated a category at a time, so keep the values of each
+// category together
+static CsvOptions withCategoryMajor(CsvOptions options)
+{
+    options.layout = DatasetLayout::CategoryMajor;
+    return options;
+}
+
+BarChart::BarChart(const std::string& csvPath, const CsvOptions& csvOptions,
+                   Timer::FloatMS tPC, int bH)
+    : parser(csvPath, withCategoryMajor(csvOptions)), timePerCategory(tPC),
+      barHeight(bH), threads(csvOptions.threads), pool(csvOptions.threads)
+{
+    // Go through each row, and put in the starting value
+    for (std::size_t r = 0; r < parser.getDataset().getRowCount(); r++)
+        rowStates.push_back(makeRow(r));
+    inRanking.resize(rowStates.size());
+    buildTimeline(MinTimelineDepth);
+
+    // Generate the colors
+    std::vector<Color> colors = generateColors(rowStates.size());
+    for (std::size_t i = 0; i < colors.size(); i++)
+        rowStates[i].color = colors[i];
+}
+
+BarChart::RowState BarChart::makeRow(std::size_t row)
+{
+    // Also get the longest row name, for measurements later
+    std::string_view name = parser.getDataset().getName(row);
+    if (name.length() > longestRowName.length())
+        longestRowName = name;
+    return {name, parser.getDataset().get(row, 0),
+            Color{0.1f, 0.1f, 0.8f, 1.0f}};
+}
+
+void BarChart::buildTimeline(std::size_t depth)
+{
+    timeline = RankTimeline(parser.getDataset(), depth, threads);
+    rankedCategory = -1;
 }
 
-BarChart::BarChart(const std::string& csvPath, Timer::FloatMS tPC, int bH)
-    : parser(csvPath), timePerCategory(tPC), barHeight(bH)
+bool BarChart::followFile()
 {
-    // Go through each row, and put in the starting value, and also
-    // get the longest row name, for measurements later
-    for (auto& row : parser.getRows())
+    const Dataset& dataset = parser.getDataset();
+    std::vector<std::size_t> newRows;
+
+    switch (parser.update())
     {
-        rowStates.push_back(
-            {row.name, row.values.front(), Color{0.1f, 0.1f, 0.8f, 1.0f}});
-        if (row.name.length() > longestRowName.length())
-            longestRowName = row.name;
+    case CsvParser::Change::None:
+        return false;
+    case CsvParser::Change::RowsAdded:
+        for (std::size_t r = rowStates.size(); r < dataset.getRowCount(); r++)
+        {
+            rowStates.push_back(makeRow(r));
+            newRows.push_back(r);
+        }
+        inRanking.resize(rowStates.size());
+        timeline.addRows(dataset, rowStates.size() - newRows.size());
+        rankedCategory = -1;
+        break;
+    case CsvParser::Change::Reloaded:
+    {
+        // Keep the rows that are still there as they were, so their bars
+        // don't jump or change color, wherever they are in the file now
+        std::unordered_map<std::string_view, RowState> previous;
+        for (auto& rs : rowStates)
+            previous.emplace(rs.name, std::move(rs));
+        rowStates.clear();
+        longestRowName = {};
+
+        for (std::size_t r = 0; r < dataset.getRowCount(); r++)
+        {
+            auto found = previous.find(dataset.getName(r));
+            if (found == previous.end())
+            {
+                rowStates.push_back(makeRow(r));
+                newRows.push_back(r);
+                continue;
+            }
+            rowStates.push_back(std::move(found->second));
+            rowStates.back().name = dataset.getName(r);
+            if (dataset.getName(r).length() > longestRowName.length())
+                longestRowName = dataset.getName(r);
+        }
+
+        // Only the rows that were ranked have a height, keep them ranked
+        // so they move from where they were
+        ranking.clear();
+        for (std::size_t r = 0; r < rowStates.size(); r++)
+            if (rowStates[r].currentHeight != 0)
+                ranking.push_back(r);
+        inRanking.assign(rowStates.size(), false);
+        buildTimeline(timeline.getDepth());
+        break;
+    }
     }
 
-    // Generate the colors
-    generateColors(rowStates);
+    // The new rows get the colors after those of the rows already there
+    std::vector<Color> colors = generateColors(rowStates.size());
+    std::size_t kept = rowStates.size() - newRows.size();
+    for (std::size_t i = 0; i < newRows.size() && kept + i < colors.size();
+         i++)
+        rowStates[newRows[i]].color = colors[kept + i];
+    return true;
 }
 
-void BarChart::update(Timer::FloatMS currentTime, unsigned spacingAboveBars)
+void BarChart::update(Timer::FloatMS currentTime, unsigned spacingAboveBars,
+                      std::size_t barsShown)
 {
     int numCategories = getCategories().size();
 
     // Calculate the current position and next position.
     currentPosition =
         std::min(currentTime / timePerCategory, float(numCategories - 1));
-    int intPrevPosition = std::min(int(currentPosition), numCategories - 2);
+    int intPrevPosition =
+        std::max(std::min(int(currentPosition), numCategories - 2), 0);
     int intNextPosition = std::min(intPrevPosition + 1, numCategories - 1);
 
     // Update the current category based on the floating point current position
-    currentCategory = getCategories()[int(currentPosition)];
+    currentCategory = int(currentPosition);
+
+    if (barsShown > timeline.getDepth())
+        buildTimeline(std::max(barsShown * TimelineDepthFactor,
+                               timeline.getDepth() * 2));
 
-    // Update the row's current values
-    for (auto& row : parser.getRows())
+    // Only the rows that could be in the top between these 2 categories are
+    // ranked. Rows that leave the ranking lose their height, so when they
+    // come back they're put straight in place rather than moving from an
+    // old one. They always come back below the bars shown, so this can't be
+    // seen
+    const auto& candidates = timeline.getCandidates(intPrevPosition);
+    if (intPrevPosition != rankedCategory)
     {
-        // Get the values based on the 2 categories we're inbetween
-        long double prevValue = row.values.at(intPrevPosition);
-        long double nextValue = row.values.at(intNextPosition);
-        long double diff = nextValue - prevValue;
-        // The current value is the current value plus a percentage of the
-        // difference between this value and the next, to make it look like
-        // we're animating toward it.
-        long double currentValue =
-            prevValue + ((currentPosition - intPrevPosition) * diff);
-
-        // Update the row's current value
-        std::find_if(rowStates.begin(), rowStates.end(),
-                     [&](const auto& x) { return x.name == row.name; })
-            ->value = currentValue;
+        for (std::size_t r : candidates)
+            inRanking[r] = true;
+        for (std::size_t r : ranking)
+            if (!inRanking[r])
+                rowStates[r].currentHeight = 0;
+        ranking.assign(candidates.begin(), candidates.end());
+        for (std::size_t r : ranking)
+            inRanking[r] = false;
+        rankedCategory = intPrevPosition;
+
+        // Copy out the values of the 2 categories we're inbetween, so they
+        // can be interpolated in one go each frame
+        const Dataset& dataset = parser.getDataset();
+        const Value* prevValues = dataset.getCategory(intPrevPosition);
+        const Value* nextValues = dataset.getCategory(intNextPosition);
+        candidatePrevValues.resize(candidates.size());
+        candidateNextValues.resize(candidates.size());
+        candidateValues.resize(candidates.size());
+        for (std::size_t i = 0; i < candidates.size(); i++)
+        {
+            candidatePrevValues[i] = prevValues[candidates[i]];
+            candidateNextValues[i] = nextValues[candidates[i]];
+        }
     }
+    if (ranking.empty())
+        return;
 
-    // Sort the bars by their values
-    std::sort(rowStates.begin(), rowStates.end(),
-              [](const auto& x, const auto& y) { return x.value > y.value; });
+    // A big ranking is split into parts that are each updated on their own
+    // thread. Every row is worked out on its own, so the parts give exactly
+    // the same results as doing it all at once
+    std::size_t count = candidates.size();
+    std::size_t parts = std::clamp<std::size_t>(count / MinRowsPerThread, 1,
+                                                pool.getThreadCount());
 
-    highestValue = rowStates.front().value;
+    // The current value is the previous value plus a percentage of the
+    // difference between it and the next, to make it look like we're
+    // animating toward it
+    partRanges.resize(parts);
+    pool.run(parts,
+             [&](std::size_t p)
+             {
+                 std::size_t begin = count * p / parts;
+                 std::size_t end = count * (p + 1) / parts;
+                 partRanges[p] = interpolate(
+                     candidatePrevValues.data() + begin,
+                     candidateNextValues.data() + begin,
+                     Value(currentPosition - intPrevPosition),
+                     candidateValues.data() + begin, end - begin);
+                 for (std::size_t i = begin; i < end; i++)
+                     rowStates[candidates[i]].value = candidateValues[i];
+             });
+    highestValue = partRanges[0].highest;
+    for (auto& range : partRanges)
+        highestValue = std::max(highestValue, range.highest);
+
+    // Sort the bars by their values, rows with the same value stay in the
+    // order they're in the file. They're already in order from the last
+    // frame, so only the bars that have passed each other need moving
+    rankSwaps = reorder(pool, parts, ranking,
+                        [&](std::size_t x, std::size_t y)
+                        {
+                            return rowStates[x].value > rowStates[y].value ||
+                                   (rowStates[x].value == rowStates[y].value &&
+                                    x < y);
+                        });
 
     // Update the bar heights
-    for (int i = 0; i < rowStates.size(); i++)
+    pool.run(parts,
+             [&](std::size_t p)
+             {
+                 std::size_t end = count * (p + 1) / parts;
+                 for (std::size_t i = count * p / parts; i < end; i++)
+                     updateHeight(rowStates[ranking[i]],
+                                  spacingAboveBars + (i * (barHeight + 10)));
+             });
+}
+
+void BarChart::updateHeight(RowState& rs, int heightAim)
+{
+    rs.heightAim = heightAim;
+    if (rs.currentHeight == 0)
+        rs.currentHeight = rs.heightAim;
+    else
     {
-        // Calculate the height aim (what the height should be)
-        RowState& rs = rowStates[i];
-        rs.heightAim = spacingAboveBars + (i * (barHeight + 10));
-        if (rs.currentHeight == 0)
-            rs.currentHeight = rs.heightAim;
-        else
-        {
-            // Update the heights, move currentHeight towards heightAim
-            int diff = rs.heightAim - rs.currentHeight;
-            // Make sure numbers like 0.4 and -0.2 are rounded to 1 and
-            // -1 respectively, as by default they'd be truncated to 0 - which
-            // will cause the difference in height to remain and not shrink
-            rs.currentHeight +=
-                (diff < 0) ? std::floor(diff / 5.0) : std::ceil(diff / 5.0);
-        }
+        // Update the heights, move currentHeight towards heightAim
+        int diff = rs.heightAim - rs.currentHeight;
+        // Make sure numbers like 0.4 and -0.2 are rounded to 1 and
+        // -1 respectively, as by default they'd be truncated to 0 - which
+        // will cause the difference in height to remain and not shrink
+        rs.currentHeight +=
+            (diff < 0) ? std::floor(diff / 5.0) : std::ceil(diff / 5.0);
     }
 }
@@ -3,18 +3,26 @@
 
 #include "viszbase/color.hpp"
 #include "viszbase/csvparser.hpp"
+#include "viszbase/interpolation.hpp"
+#include "viszbase/ranktimeline.hpp"
+#include "viszbase/threadpool.hpp"
 #include "viszbase/timer.hpp"
 
 class BarChart
 {
 public:
-    BarChart(const std::string& csvPath, Timer::FloatMS timePerCategory,
-             int barHeight);
-    void update(Timer::FloatMS currentTime, unsigned spcaingAboveBars);
+    BarChart(const std::string& csvPath, const CsvOptions& csvOptions,
+             Timer::FloatMS timePerCategory, int barHeight);
+    // Only the rows that could be in the top 'barsShown' are updated
+    void update(Timer::FloatMS currentTime, unsigned spcaingAboveBars,
+                std::size_t barsShown);
+    // Takes in any changes to the CSV file when it's being followed, returns
+    // true if there were any
+    bool followFile();
 
     const std::string& getName() { return parser.getName(); }
-    const std::string& getLongestRowName() { return longestRowName; }
-    const long double& getHighestValue() { return highestValue; }
+    std::string_view getLongestRowName() { return longestRowName; }
+    const Value& getHighestValue() { return highestValue; }
     const float& getCurrentPosition() { return currentPosition; }
     const std::vector<std::string>& getCategories()
     {
@@ -23,27 +31,58 @@ public:
 
     struct RowState
     {
-        std::string name;
-        long double value;
+        // Points into the dataset
+        std::string_view name;
+        Value value;
         Color color;
         // To animate the bar moving positions
         int currentHeight;
         int heightAim;
     };
+    // In the same order as the rows of the dataset, so a row's index in the
+    // dataset is its index here
     const std::vector<RowState>& getRowStates() { return rowStates; }
+    // The indices of the rows that could be shown, from the highest value to
+    // the lowest. Only these rows' values and heights are kept up to date
+    const std::vector<std::size_t>& getRanking() { return ranking; }
+    // The number of times 2 bars swapped places in the last update
+    std::size_t getRankSwaps() { return rankSwaps; }
 
-    const std::string& getCurrentCategory() { return currentCategory; }
+    const std::string& getCurrentCategory()
+    {
+        return getCategories()[currentCategory];
+    }
 
 private:
     std::vector<RowState> rowStates;
-    std::string longestRowName;
-    long double highestValue;
-    std::string currentCategory;
+    std::vector<std::size_t> ranking;
+    // The category the ranking was made for, or -1 if it needs making again
+    int rankedCategory = -1;
+    std::size_t rankSwaps = 0;
+    // The values of the ranking's candidates, in the same order, at the
+    // categories either side and right now
+    std::vector<Value> candidatePrevValues, candidateNextValues,
+        candidateValues;
+    // The range of the current values in each part of the ranking
+    std::vector<ValueRange<Value>> partRanges;
+    // Space to mark rows in while making the ranking, left all false
+    std::vector<bool> inRanking;
+    RankTimeline timeline;
+    std::string_view longestRowName;
+    Value highestValue;
+    std::size_t currentCategory = 0;
     float currentPosition;
 
     CsvParser parser;
     Timer::FloatMS timePerCategory;
     int barHeight;
+    unsigned threads;
+    ThreadPool pool;
+
+    RowState makeRow(std::size_t row);
+    // Moves the bar's height a step towards 'heightAim'
+    void updateHeight(RowState& rs, int heightAim);
+    void buildTimeline(std::size_t depth);
 };
 
 #endif
@@ -9,9 +9,11 @@ int main(int argc, char** argv)
     try
     {
         // Parse arguments
-        CommandLineParser parser(argc, argv,
-                                 {"-csv", "-barheight", "-font",
-                                  "-timepercategory", "-decimalplaces"});
+        CommandLineParser parser(
+            argc, argv,
+            {"-csv", "-barheight", "-font", "-timepercategory",
+             "-decimalplaces", "-decimalseparator", "-thousandsseparator",
+             "-cache", "-follow", "-format", "-categoryorder", "-fontmode"});
         // Start application with those parsed arguments
         Application app(parser.getArguments());
         return app.run();
@@ -0,0 +1,11 @@
+#ifndef CACHE_DIRECTORY_HPP
+#define CACHE_DIRECTORY_HPP
+
+#include <filesystem>
+
+// Where files kept between runs go, which is made if it isn't there. Is
+// numvisz in XDG_CACHE_HOME or ~/.cache, or numvisz/cache in LOCALAPPDATA on
+// Windows, and falls back to the temporary directory
+std::filesystem::path getCacheDirectory();
+
+#endif
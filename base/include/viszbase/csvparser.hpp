@@ -1,29 +1,105 @@
 #ifndef CSVPARSER_HPP
 #define CSVPARSER_HPP
 
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
-struct Row
+#include "commandlineparser.hpp"
+#include "csvscanner.hpp"
+#include "dataset.hpp"
+#include "datasetcache.hpp"
+#include "filewatcher.hpp"
+#include "longformat.hpp"
+#include "numberparser.hpp"
+
+// How the values are arranged in the file
+enum class TableFormat
 {
-    std::string name;
-    std::vector<long double> values;
+    // A row for each name, with a column for each category after the name
+    Wide,
+    // A row for each value, with its name, category and value in that order
+    Long,
+};
+
+struct CsvOptions
+{
+    // Map the file into memory and tokenize it in place, instead of reading
+    // it all into memory first. Falls back to reading if it can't be mapped
+    bool memoryMap = true;
+    // Number of threads the rows are parsed on, 0 uses every hardware thread
+    unsigned threads = 0;
+    // Instructions used to find the commas, quotes and newlines
+    CsvScannerKind scanner = CsvScannerKind::Auto;
+    // How the numbers are written, if not set it is worked out from the first
+    // rows, or failing that taken from the system's locale
+    std::optional<NumberFormat> numberFormat;
+    // How the parsed values are laid out in memory
+    DatasetLayout layout = DatasetLayout::RowMajor;
+    // Whether the parsed file is cached, so it loads faster next time
+    CacheMode cache = CacheMode::On;
+    // Watch the file for changes, and read whatever is added to it
+    bool follow = false;
+    TableFormat tableFormat = TableFormat::Wide;
+    // Wide files keep the order of their columns, this is for long files
+    CategoryOrder categoryOrder = CategoryOrder::FirstAppearance;
+
+    // Reads the options given on the command line:
+    // -decimalseparator <char>, -thousandsseparator <char, or none>,
+    // -cache <on, off or rebuild>, -follow <on or off>,
+    // -format <wide or long> and -categoryorder <appearance or sorted>
+    static CsvOptions fromArguments(const Arguments& args);
 };
 
 class CsvParser
 {
 public:
-    explicit CsvParser(const std::string& fileName);
+    explicit CsvParser(const std::string& fileName,
+                       const CsvOptions& options = CsvOptions());
 
     const std::vector<std::string>& getCategories() const { return categories; }
-    const std::vector<Row>& getRows() const { return rows; }
+    const Dataset& getDataset() const { return dataset; }
     std::string& getName() { return name; }
 
+    enum class Change
+    {
+        None,
+        // Rows were added to the end of the dataset, the rest are unchanged
+        RowsAdded,
+        // The file was read again from the start, so anything could have
+        // changed, e.g. a category was added
+        Reloaded,
+    };
+
+    // When following the file, reads in whatever has changed since it was
+    // last read. Rows added to the end are read on their own, in time that
+    // depends only on their size, anything else means reading it all again.
+    // Names from the dataset before it was read again stay valid until this
+    // is next called, to match them up with the new rows
+    Change update();
+
 private:
+    std::string fileName;
+    CsvOptions options;
+    std::unique_ptr<FileWatcher> watcher;
+
+    // What has been read so far, to tell what has changed since
+    std::optional<NumberFormat> format;
+    std::size_t parsedSize = 0;
+    std::string parsedHeader;
+    std::string parsedTail;
+
     std::string name;
 
     std::vector<std::string> categories;
-    std::vector<Row> rows;
+    Dataset dataset;
+    // The dataset from before the file was last read again
+    Dataset replacedDataset;
+
+    std::string_view getCompleteLines(std::string_view data) const;
+    void parse(std::string_view data, CacheMode cacheMode);
+    void setParsedEnd(std::string_view data);
 };
 
 #endif
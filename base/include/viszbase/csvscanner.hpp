@@ -0,0 +1,63 @@
+#ifndef CSV_SCANNER_HPP
+#define CSV_SCANNER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// The CSV's structural characters within a 64 byte block, bit i of a mask
+// is set if byte i of the block is that character
+struct CsvBlockMasks
+{
+    std::uint64_t commas;
+    std::uint64_t quotes;
+    std::uint64_t newlines;
+};
+
+// Which instructions the block masks are built with
+enum class CsvScannerKind
+{
+    // The best one the CPU supports, picked at runtime
+    Auto,
+    Scalar,
+    SSE2,
+    AVX2,
+};
+
+// Finds structural characters in CSV data a block at a time. The masks of
+// the block last looked at are kept, so walking forwards through the cells
+// of a row only scans each block once
+class CsvScanner
+{
+public:
+    explicit CsvScanner(std::string_view data,
+                        CsvScannerKind kind = CsvScannerKind::Auto);
+
+    // Each returns the position of the next such character at or after
+    // 'pos', or the size of the data if there isn't one
+    std::size_t findSeparator(std::size_t pos); // ',' or '\n'
+    std::size_t findQuote(std::size_t pos);
+    std::size_t findNewline(std::size_t pos);
+
+    CsvScannerKind getKind() const { return kind; }
+
+    // Whether the CPU can run the given kind of scanner
+    static bool isSupported(CsvScannerKind kind);
+    static CsvScannerKind getBestKind();
+
+private:
+    using ScanFunction = CsvBlockMasks (*)(const char*);
+
+    std::string_view data;
+    CsvScannerKind kind;
+    ScanFunction scanBlock;
+
+    std::size_t blockStart;
+    CsvBlockMasks masks;
+
+    template <std::uint64_t CsvBlockMasks::*... Masks>
+    std::size_t find(std::size_t pos);
+    void loadBlock(std::size_t start);
+};
+
+#endif
@@ -0,0 +1,244 @@
+#ifndef DATASET_HPP
+#define DATASET_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "stringpool.hpp"
+
+// The type values are stored and animated in, picked when building with
+// -DVISZBASE_PRECISION=float|double|longdouble. float halves the memory of
+// double, long double is only worth it for values double can't represent
+#if defined(VISZBASE_PRECISION_FLOAT)
+using Value = float;
+#elif defined(VISZBASE_PRECISION_LONG_DOUBLE)
+using Value = long double;
+#else
+using Value = double;
+#endif
+
+// How the values of a dataset are laid out in memory
+enum class DatasetLayout
+{
+    // A row's values are next to each other
+    RowMajor,
+    // Every row's value for a category are next to each other, which suits
+    // the charts as they go through all the rows at one category each frame
+    CategoryMajor,
+};
+
+// A table of values with a name for each row, and a value for each category
+// in every row. All of the values are kept in a single block of memory,
+// which is either owned by the dataset or borrowed, such as from a mapped
+// file. Borrowed values are copied before anything changes them. The names
+// are kept in a string pool, so the views of them handed out stay valid
+// until the rows are replaced, or the dataset is destroyed
+template <typename T> class BasicDataset
+{
+public:
+    explicit BasicDataset(DatasetLayout layout = DatasetLayout::RowMajor)
+        : layout{layout}
+    {
+    }
+
+    std::size_t getRowCount() const { return names.size(); }
+    std::size_t getCategoryCount() const { return categoryCount; }
+    DatasetLayout getLayout() const { return layout; }
+
+    const std::vector<std::string_view>& getNames() const { return names; }
+    std::string_view getName(std::size_t row) const { return names[row]; }
+
+    T get(std::size_t row, std::size_t category) const
+    {
+        return getValues()[index(row, category)];
+    }
+
+    // The values of a row, in category order. Only valid when row major
+    const T* getRow(std::size_t row) const
+    {
+        return getValues() + row * categoryCount;
+    }
+
+    // Each row's value for a category, in row order. Only valid when
+    // category major
+    const T* getCategory(std::size_t category) const
+    {
+        return getValues() + category * rowCapacity;
+    }
+
+    // Only allowed while there are no rows
+    void setCategoryCount(std::size_t count) { categoryCount = count; }
+
+    void reserveRows(std::size_t count)
+    {
+        ownValues();
+        names.reserve(count);
+        if (layout == DatasetLayout::RowMajor)
+            values.reserve(count * categoryCount);
+        else if (count > rowCapacity)
+            setRowCapacity(count);
+    }
+
+    // Adds rows to the end, 'rowValues' holds getCategoryCount() values for
+    // each name, a row at a time
+    void appendRows(const std::vector<std::string_view>& rowNames,
+                    const std::vector<T>& rowValues)
+    {
+        ownValues();
+        std::size_t first = names.size();
+        std::size_t count = rowNames.size();
+
+        if (layout == DatasetLayout::RowMajor)
+            values.insert(values.end(), rowValues.begin(), rowValues.end());
+        else
+        {
+            // Grow by at least double, so adding rows one at a time doesn't
+            // move every value each time
+            if (first + count > rowCapacity)
+                setRowCapacity(std::max(first + count, rowCapacity * 2));
+
+            for (std::size_t r = 0; r < count; r++)
+                for (std::size_t c = 0; c < categoryCount; c++)
+                    values[c * rowCapacity + first + r] =
+                        rowValues[r * categoryCount + c];
+        }
+
+        for (std::string_view name : rowNames)
+            names.push_back(namePool.get(namePool.intern(name)));
+    }
+
+    // Replaces all of the rows, 'layoutValues' holds getCategoryCount()
+    // values for each name, already in this dataset's layout
+    void setRows(const std::vector<std::string_view>& rowNames,
+                 std::vector<T>&& layoutValues)
+    {
+        setNames(rowNames);
+        values = std::move(layoutValues);
+        rowCapacity = names.size();
+        borrowedValues = nullptr;
+        borrowedStorage.reset();
+    }
+
+    // As above, but with a row for each string in the pool, in id order
+    void setRows(StringPool&& rowNames, std::vector<T>&& layoutValues)
+    {
+        namePool = std::move(rowNames);
+        names.resize(namePool.size());
+        for (std::size_t r = 0; r < names.size(); r++)
+            names[r] = namePool.get(r);
+        values = std::move(layoutValues);
+        rowCapacity = names.size();
+        borrowedValues = nullptr;
+        borrowedStorage.reset();
+    }
+
+    // As the first, but borrows the values rather than taking them.
+    // 'storage' keeps the memory they're in alive for as long as they're
+    // borrowed
+    void setRows(const std::vector<std::string_view>& rowNames,
+                 std::shared_ptr<const void> storage, const T* layoutValues)
+    {
+        setNames(rowNames);
+        values.clear();
+        values.shrink_to_fit();
+        rowCapacity = names.size();
+        borrowedValues = layoutValues;
+        borrowedStorage = std::move(storage);
+    }
+
+    // Rearranges the values into the other layout
+    void setLayout(DatasetLayout newLayout)
+    {
+        if (newLayout == layout)
+            return;
+
+        std::vector<T> rearranged(names.size() * categoryCount);
+        for (std::size_t r = 0; r < names.size(); r++)
+            for (std::size_t c = 0; c < categoryCount; c++)
+            {
+                std::size_t i = (newLayout == DatasetLayout::RowMajor)
+                                    ? r * categoryCount + c
+                                    : c * names.size() + r;
+                rearranged[i] = get(r, c);
+            }
+
+        values = std::move(rearranged);
+        rowCapacity = names.size();
+        layout = newLayout;
+        borrowedValues = nullptr;
+        borrowedStorage.reset();
+    }
+
+    // Bytes of memory allocated for the values and the names, borrowed
+    // values aren't counted
+    std::size_t getMemoryUsage() const
+    {
+        return values.capacity() * sizeof(T) +
+               names.capacity() * sizeof(std::string_view) +
+               namePool.getMemoryUsage();
+    }
+
+private:
+    DatasetLayout layout;
+    std::size_t categoryCount = 0;
+    // When category major, the space for rows each category has
+    std::size_t rowCapacity = 0;
+
+    // Rows with the same name share the one copy of it in the pool
+    StringPool namePool;
+    std::vector<std::string_view> names;
+    std::vector<T> values;
+    // Set when the values are borrowed, instead of being in 'values'
+    const T* borrowedValues = nullptr;
+    std::shared_ptr<const void> borrowedStorage;
+
+    const T* getValues() const
+    {
+        return borrowedValues ? borrowedValues : values.data();
+    }
+
+    // Copies borrowed values, so they can be changed
+    void ownValues()
+    {
+        if (!borrowedValues)
+            return;
+        values.assign(borrowedValues,
+                      borrowedValues + rowCapacity * categoryCount);
+        borrowedValues = nullptr;
+        borrowedStorage.reset();
+    }
+
+    void setNames(const std::vector<std::string_view>& rowNames)
+    {
+        namePool = StringPool();
+        names.clear();
+        names.reserve(rowNames.size());
+        for (std::string_view name : rowNames)
+            names.push_back(namePool.get(namePool.intern(name)));
+    }
+
+    std::size_t index(std::size_t row, std::size_t category) const
+    {
+        return (layout == DatasetLayout::RowMajor)
+                   ? row * categoryCount + category
+                   : category * rowCapacity + row;
+    }
+
+    void setRowCapacity(std::size_t capacity)
+    {
+        std::vector<T> moved(capacity * categoryCount);
+        for (std::size_t c = 0; c < categoryCount; c++)
+            std::copy_n(values.begin() + c * rowCapacity, names.size(),
+                        moved.begin() + c * capacity);
+        values = std::move(moved);
+        rowCapacity = capacity;
+    }
+};
+
+using Dataset = BasicDataset<Value>;
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef DATASET_CACHE_HPP
+#define DATASET_CACHE_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "dataset.hpp"
+
+// Whether a CSV file's parsed contents are cached in a file next to it
+enum class CacheMode
+{
+    // Load from the cache if it's up to date, otherwise parse and write it
+    On,
+    // Always parse, and leave any cache file alone
+    Off,
+    // Always parse, and write the cache file again
+    Rebuild,
+};
+
+// What a cache file has to match for it to be used
+struct DatasetCacheKey
+{
+    std::uint64_t fileSize;
+    std::int64_t modifiedTime;
+    // Hash of the CSV file's contents, only samples of them for large files
+    std::uint64_t contentHash;
+    // Hash of the parser settings that change the values parsed
+    std::uint64_t settingsHash;
+
+    bool operator==(const DatasetCacheKey& other) const;
+};
+
+// A binary copy of a parsed CSV file, kept next to it as <file>.nvzcache.
+// It holds the title, categories, row names and the block of values, and
+// is mapped into memory to load it
+class DatasetCache
+{
+public:
+    // 'contents' is the CSV file's data, and 'settings' describes the parser
+    // settings which change the values parsed from it
+    DatasetCache(const std::string& csvFileName, std::string_view contents,
+                 std::string_view settings);
+
+    // Fills in the parsed CSV from the cache file, returns false and leaves
+    // them untouched if there isn't one or it is out of date
+    bool load(std::string& name, std::vector<std::string>& categories,
+              Dataset& dataset) const;
+
+    // Writes the cache file, replacing any that is already there. Returns
+    // false if it couldn't be written, e.g. the directory is read only
+    bool save(const std::string& name,
+              const std::vector<std::string>& categories,
+              const Dataset& dataset) const;
+
+    const std::string& getPath() const { return path; }
+
+private:
+    std::string path;
+    DatasetCacheKey key;
+    // False if the CSV file's size or time couldn't be read
+    bool valid;
+};
+
+#endif
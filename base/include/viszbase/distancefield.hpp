@@ -0,0 +1,17 @@
+#ifndef DISTANCE_FIELD_HPP
+#define DISTANCE_FIELD_HPP
+
+#include <vector>
+
+// Turns an 8 bit coverage bitmap, such as a rendered glyph, into a signed
+// distance field. Each pixel of the field is how far it is from the edge of
+// the shape, 128 right on the edge, higher inside and lower outside, reaching
+// 0 or 255 'spread' pixels away. The field is 'spread' pixels larger than
+// the bitmap on every side, so the distances outside it fit. Partly covered
+// pixels place the edge within the pixel, so it's accurate to well under a
+// pixel. Takes time in proportion to the number of pixels
+void makeDistanceField(const unsigned char* bitmap, int width, int height,
+                       int pitch, int spread,
+                       std::vector<unsigned char>& field);
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef FILE_WATCHER_HPP
+#define FILE_WATCHER_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+// Tells when a file has been written to, or replaced. Uses inotify on Linux,
+// elsewhere the file's size and modification time are compared instead
+class FileWatcher
+{
+public:
+    explicit FileWatcher(const std::string& fileName);
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // Whether the file has changed since this was last called, doesn't wait
+    // for it to change
+    bool hasChanged();
+
+private:
+    std::filesystem::path path;
+
+#ifdef __linux__
+    int inotifyFd = -1;
+#else
+    std::uintmax_t lastSize = 0;
+    std::filesystem::file_time_type lastTime;
+#endif
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef FONT_MANAGER_HPP
+#define FONT_MANAGER_HPP
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+struct FontFace;
+
+// One size of a font file, which glyphs are rendered from as they're needed.
+// Sizes of the same file share the one parsed face
+class Font
+{
+public:
+    Font() = default;
+    ~Font();
+
+    Font(Font&& other) noexcept;
+    Font& operator=(Font&& other) noexcept;
+
+    Font(const Font&) = delete;
+    Font& operator=(const Font&) = delete;
+
+    // The face, set to this size. Only stays at this size until another
+    // size of the same file is used
+    FT_Face getFace() const;
+    // The contents of the font file
+    std::string_view getFileData() const;
+
+private:
+    friend class FontManager;
+
+    std::shared_ptr<FontFace> face;
+    FT_Size size = nullptr;
+};
+
+// Opens fonts for the whole program with a single FreeType library. Each
+// file is mapped and parsed once however many sizes it's used at, and is
+// closed once the last of them is gone. Isn't thread safe, fonts are only
+// used from the thread drawing them
+class FontManager
+{
+public:
+    static FontManager& getInstance();
+
+    FontManager(const FontManager&) = delete;
+    FontManager& operator=(const FontManager&) = delete;
+
+    // The font in the file at 'size' points, at 96 DPI
+    Font open(const std::string& filePath, int size);
+
+private:
+    FT_Library library;
+    // By file path, only kept while the face is in use
+    std::unordered_map<std::string, std::weak_ptr<FontFace>> faces;
+
+    FontManager();
+    ~FontManager();
+};
+
+#endif
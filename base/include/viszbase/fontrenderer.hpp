@@ -1,60 +1,221 @@
 #ifndef FONTRENDERER_HPP
 #define FONTRENDERER_HPP
 
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
-#include <ft2build.h>
-#include FT_FREETYPE_H
-
+#include "fontmanager.hpp"
+#include "glyphatlas.hpp"
+#include "glyphcache.hpp"
 #include "math.hpp"
 #include "shader.hpp"
 #include "commandlineparser.hpp"
 
 #include "color.hpp"
 
+// How a font's characters are rendered
+enum class GlyphMode
+{
+    // At the size they're drawn at, which is sharpest for small text
+    Bitmap,
+    // Once, at a large size, as the distance of each pixel from the edge,
+    // which the shader turns back into edges at any size. Every size of a
+    // font shares the one set of glyphs, and changing size is free
+    Sdf
+};
+
+// Reads -fontmode <bitmap or sdf> from the command line
+GlyphMode glyphModeFromArguments(const Arguments& args);
+
 class FontRenderer
 {
+private:
+    // What the shader gets for each character drawn
+    struct GlyphQuad
+    {
+        // Where on screen, and where in the atlas page in pixels
+        float x, y, width, height;
+        float textureX, textureY, textureWidth, textureHeight;
+    };
+
 public:
+    // A string already laid out in this font, so it can be measured and
+    // drawn without looking at its characters again
+    class TextRun
+    {
+    public:
+        int getWidth() const { return width; }
+
+    private:
+        friend class FontRenderer;
+        std::string text;
+        int width = 0;
+        // Each atlas page with characters on it, and their quads placed
+        // relative to where the text starts
+        std::vector<unsigned> pages;
+        // May be longer than 'pages' when the run has been reused
+        std::vector<std::vector<GlyphQuad>> pageQuads;
+        // The last frame it was used in
+        std::uint64_t lastUsed = 0;
+    };
+
+    // Once this many runs are kept, those not used since the last flush are
+    // let go of to make room
+    static constexpr std::size_t MaxTextRuns = 4096;
+    // The most atlas pages each font and size keeps, each a megabyte. Once
+    // they're full, the page used the longest ago is emptied for new
+    // characters
+    static constexpr std::size_t MaxAtlasPages = 8;
+
+    // How well the characters drawn fit in the atlas pages
+    struct GlyphStats
+    {
+        // Characters looked up while laying out text, that were already
+        // rendered or had to be
+        std::uint64_t hits, misses;
+        // Pages emptied to make room
+        std::uint64_t evictions;
+        std::size_t pageCount;
+        // Bytes of texture memory
+        std::size_t memoryUsage;
+    };
+
     FontRenderer();
-    void loadFont(const std::string& filePath, int size);
+    ~FontRenderer();
+
+    FontRenderer(const FontRenderer&) = delete;
+    FontRenderer& operator=(const FontRenderer&) = delete;
 
-    void drawMsg(float x, float y, const std::string& msg,
+    // Characters are rendered from the font the first time they're used
+    void loadFont(const std::string& filePath, int size,
+                  GlyphMode mode = GlyphMode::Bitmap);
+    // Changes the size text is drawn at. In SDF mode the same glyphs are
+    // just scaled, in bitmap mode they're rendered again at the new size
+    void setSize(float size);
+
+    // Draw text straight away
+    void drawMsg(float x, float y, std::string_view msg,
                  math::Matrix<4, 4> projection);
     void drawLongDouble(float x, float y, const long double& num,
                         int decimalPoints, math::Matrix<4, 4> projection);
 
-    int getWidthOfMsg(const std::string& msg);
+    // Queue text to be drawn by the next flush, so that a whole frame of
+    // text can be drawn with a draw call per atlas page
+    void queueMsg(float x, float y, std::string_view msg);
+    void queueLongDouble(float x, float y, const long double& num,
+                         int decimalPoints);
+    void queueRun(float x, float y, const TextRun& run);
+    // Draws the queued text, then empties the queue
+    void flush(const math::Matrix<4, 4>& projection);
+    // Call once each frame is shown, after every renderer's text is drawn.
+    // Atlas pages are only emptied for new characters once they've gone a
+    // whole frame without being used
+    static void endFrame();
+
+    // The string laid out in this font, which is kept for next time. It
+    // stays valid until after the next flush
+    const TextRun& getTextRun(std::string_view msg);
+    // The number formatted to the system's locale and laid out, so that it
+    // can be measured and drawn from the one result. It isn't kept, as
+    // values change from frame to frame, and it stays valid until the next
+    // number is laid out
+    const TextRun& getNumberRun(const long double& num, int decimalPoints);
+
+    int getWidthOfMsg(std::string_view msg);
     int getWidthOfLongDouble(const long double& num, int decimalPoints);
 
     int getFontHeight() const { return fontHeight; }
 
+    // For the glyphs of the current font and size, which in SDF mode are
+    // shared with every renderer using the font
+    GlyphStats getGlyphStats() const;
+
 private:
-    FT_Library library;
-    FT_Face face;
+    // Rendered SDF glyphs are this size, in points, and scaled to the size
+    // they're drawn at. Large enough that scaling up a little stays sharp
+    static constexpr int SdfSize = 32;
+    // How far from their edges SDF glyphs hold distances, in pixels at
+    // SdfSize. Is as far as an outline or glow could go
+    static constexpr int SdfSpread = 8;
+
     struct Character
     {
-        unsigned textureID;
+        // Where its bitmap is in the atlas
+        GlyphAtlas::Location location;
         unsigned width, height;
-        unsigned advanceX;
+        float advanceX;
 
         int bitmap_top, bitmap_left;
         int bearingY;
     };
 
+    // The characters of a font at one size, or in SDF mode at every size.
+    // Those rendered are saved to the glyph cache once it's done with, to
+    // be loaded the next time rather than rendered again
+    struct GlyphSet
+    {
+        ~GlyphSet();
+
+        Font font;
+        GlyphMode mode;
+        // In points
+        int size;
+        // The furthest any character goes above and below the baseline
+        int yMax, yMin;
+
+        GlyphAtlas atlas{MaxAtlasPages};
+        std::unordered_map<char32_t, Character> characters;
+        std::uint64_t hits = 0, misses = 0;
+
+        std::optional<GlyphCache> cache;
+        // The cache is only saved again if characters have been rendered
+        // since it was loaded
+        bool changed = false;
+    };
+
+    std::string filePath;
+    std::shared_ptr<GlyphSet> glyphs;
+    // From the size the glyphs were rendered at to the size drawn at
+    float scale = 1;
+
     int fontHeight;
     int yMax;
     int yMin;
 
-    unsigned VAO, VBO;
-    Shader fontShader;
+    unsigned VAO, VBO, instanceVBO;
+    // How many quads the instance buffer has room for
+    std::size_t instanceCapacity = 0;
+    // Shared by every renderer
+    std::shared_ptr<Shader> fontShader;
+    // Only got once a font is loaded in SDF mode
+    std::shared_ptr<Shader> sdfShader;
+
+    // The quads queued to be drawn from each atlas page
+    std::vector<std::vector<GlyphQuad>> pageQuads;
 
-    std::unordered_map<char32_t, Character> characterMap;
+    // Keyed by the run's own copy of its text
+    std::unordered_map<std::string_view, std::unique_ptr<TextRun>> textRuns;
+    // Counts the flushes, to tell which runs are still in use
+    std::uint64_t frame = 0;
+    // The atlas's eviction count when runs on emptied pages were last let
+    // go of
+    std::uint64_t evictionsSeen = 0;
+    // Reused for every number, so they don't allocate once it's grown
+    TextRun numberRun;
 
-    math::Matrix<4, 4> translate;
-    math::Matrix<4, 4> scale;
-    math::Matrix<4, 4> result;
+    // The glyph set for SDF mode is shared by every renderer using the file
+    static std::shared_ptr<GlyphSet> getSdfGlyphSet(const std::string& path);
+    static std::shared_ptr<GlyphSet> openGlyphSet(const std::string& path,
+                                                  int size, GlyphMode mode);
+    static const Character& getCharacter(GlyphSet& glyphs, char32_t c);
 
-    void loadCharacter(char32_t c);
+    void layOut(std::string_view msg, TextRun& run);
+    void evictTextRuns();
+    void dropEvictedRuns();
 };
 #endif
@@ -0,0 +1,119 @@
+#ifndef GLYPH_ATLAS_HPP
+#define GLYPH_ATLAS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Packs glyph bitmaps into a few large textures, so drawing text only needs
+// a texture bound per page rather than per character. Glyphs are placed
+// left to right along shelves, a new shelf is started below when one fills
+// up, and a new page when a page fills up. A new page starts out short and
+// doubles in height as it needs to, so a few glyphs only take a little
+// memory. Locations are in pixels, so they stay the same as it grows.
+//
+// Once it has as many pages as it's allowed, the page used the longest ago
+// is emptied and glyphs are added to it instead, so the memory it takes
+// stays the same however many different characters are drawn
+class GlyphAtlas
+{
+public:
+    // The width of each page, and the most height, in pixels
+    static constexpr int PageSize = 1024;
+    static constexpr int MinPageHeight = 64;
+
+    struct Location
+    {
+        unsigned page;
+        int x, y;
+    };
+
+    // Where the next glyph goes, which is saved along with the pages so that
+    // more can be added once they're loaded again
+    struct Packing
+    {
+        std::int32_t shelfX, shelfY, shelfHeight;
+        // The page glyphs are being added to
+        std::uint32_t currentPage;
+    };
+
+    // 0 allows any number of pages
+    explicit GlyphAtlas(std::size_t maxPages = 0);
+    ~GlyphAtlas();
+
+    GlyphAtlas(const GlyphAtlas&) = delete;
+    GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+    // Copies an 8 bit bitmap into the atlas, 'pitch' bytes apart from one row
+    // to the next, and returns where it went. If a page had to be emptied to
+    // make room, it's the page returned, and the eviction count goes up
+    Location add(const unsigned char* bitmap, int width, int height,
+                 int pitch);
+
+    unsigned getTexture(unsigned page) const { return pages[page].texture; }
+    std::size_t getPageCount() const { return pages.size(); }
+    std::size_t getMaxPages() const { return maxPages; }
+
+    // Marks the page as used in this frame. Pages used in this frame or the
+    // last aren't emptied, as text queued to be drawn may still need them
+    void touch(unsigned page);
+    // Call once each frame is shown. Counts the frames for every atlas, as
+    // the text of one frame is drawn through several of them and from
+    // several renderers that each flush on their own. No page is emptied
+    // until it's called
+    static void endFrame();
+
+    // How many times a page has been emptied to make room
+    std::uint64_t getEvictionCount() const { return evictions; }
+    // Whether the page has been emptied since there had been
+    // 'evictionCount' evictions
+    bool wasEvictedSince(unsigned page, std::uint64_t evictionCount) const
+    {
+        return pages[page].evictedAt > evictionCount;
+    }
+
+    // Bytes of texture memory used by the pages
+    std::size_t getMemoryUsage() const;
+
+    Packing getPacking() const;
+    int getPageHeight(unsigned page) const { return pages[page].height; }
+    // Reads the page's pixels back from its texture, a row of PageSize
+    // pixels at a time
+    void readPage(unsigned page, std::vector<unsigned char>& pixels) const;
+    // Fills an empty atlas with 'pageCount' pages read back from another,
+    // one after the other in 'pixels', each as high as 'heights' says
+    void loadPages(const unsigned char* pixels, const std::uint32_t* heights,
+                   std::size_t pageCount, const Packing& packing);
+
+private:
+    // Left empty between glyphs, so filtering doesn't pick up the
+    // neighbouring ones
+    static constexpr int Padding = 1;
+
+    struct Page
+    {
+        unsigned texture;
+        int height;
+        // The frame it was last used in
+        std::uint64_t lastUsed;
+        // The eviction count just after it was last emptied
+        std::uint64_t evictedAt;
+    };
+
+    std::vector<Page> pages;
+    std::size_t maxPages;
+    // Where the next glyph goes
+    unsigned currentPage = 0;
+    int shelfX = PageSize, shelfY = 0, shelfHeight = 0;
+
+    std::uint64_t evictions = 0;
+
+    // Moves on to an empty page, a new one or the one used the longest ago
+    void nextPage();
+    void addPage();
+    void createPage(const unsigned char* pixels, int height);
+    void evictPage(unsigned page);
+    void growCurrentPage();
+};
+
+#endif
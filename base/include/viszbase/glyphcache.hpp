@@ -0,0 +1,64 @@
+#ifndef GLYPH_CACHE_HPP
+#define GLYPH_CACHE_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "glyphatlas.hpp"
+
+// A rendered character, as it's kept in the cache
+struct CachedGlyph
+{
+    std::uint32_t codepoint;
+    std::uint32_t page;
+    std::int32_t x, y;
+    std::uint32_t width, height;
+    float advanceX;
+    std::int32_t bitmapTop, bitmapLeft, bearingY;
+};
+
+// What a cache file has to match for it to be used
+struct GlyphCacheKey
+{
+    std::uint64_t fileSize;
+    // Hash of the font file's contents, only samples of them for large fonts
+    std::uint64_t contentHash;
+    // Hash of the settings the glyphs were rendered with
+    std::uint64_t settingsHash;
+
+    bool operator==(const GlyphCacheKey& other) const;
+};
+
+// The glyphs rendered from a font and the atlas they're packed in, kept in
+// the user's cache directory so that later runs load them rather than
+// render them all again. Files are named after a hash of the font file's
+// contents and the settings the glyphs were rendered with, such as the size
+// and mode. The atlas pages are uploaded straight from the mapped file
+class GlyphCache
+{
+public:
+    // 'fontContents' is the font file's data, and 'settings' describes
+    // everything that changes how glyphs are rendered from it
+    GlyphCache(std::string_view fontContents, std::string_view settings);
+
+    // Fills the empty atlas with the cached pages, and 'glyphs' with the
+    // characters in them. Returns false and leaves them untouched if there
+    // isn't a cache file or it doesn't match
+    bool load(GlyphAtlas& atlas, std::vector<CachedGlyph>& glyphs) const;
+
+    // Writes the cache file, replacing any that is already there. Returns
+    // false if it couldn't be written
+    bool save(const GlyphAtlas& atlas,
+              const std::vector<CachedGlyph>& glyphs) const;
+
+    // In the cache directory, and named *.nvzglyphs
+    const std::string& getPath() const { return path; }
+
+private:
+    std::string path;
+    GlyphCacheKey key;
+};
+
+#endif
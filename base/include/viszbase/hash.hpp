@@ -0,0 +1,17 @@
+#ifndef HASH_HPP
+#define HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// 64 bit FNV-1a, continued from 'hash', which starts at HashStart
+constexpr std::uint64_t HashStart = 0xcbf29ce484222325;
+std::uint64_t hashBytes(std::uint64_t hash, const char* data, std::size_t size);
+
+// Hashes the whole of a file's contents if it's small, and evenly spaced
+// samples of it if it's large, so checking a cache doesn't mean reading
+// every byte
+std::uint64_t hashContents(std::string_view contents);
+
+#endif
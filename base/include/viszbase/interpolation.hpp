@@ -0,0 +1,44 @@
+#ifndef INTERPOLATION_HPP
+#define INTERPOLATION_HPP
+
+#include <cstddef>
+
+// Which instructions the values are interpolated with
+enum class InterpolationKind
+{
+    // The best one the CPU supports, picked at runtime
+    Auto,
+    Scalar,
+    SSE2,
+    AVX2,
+};
+
+// The lowest and highest of a set of values. With no values, lowest is
+// infinity and highest is minus infinity
+template <typename T> struct ValueRange
+{
+    T lowest;
+    T highest;
+};
+
+// Moves 'count' values a fraction 't' of the way from 'from' to 'to', the way
+// the charts animate from one category to the next, writing them to 'out'.
+// The lowest and highest of them are worked out along the way. Float and
+// double use SIMD instructions, long double is always scalar. Every kind
+// gives exactly the same results
+ValueRange<float> interpolate(const float* from, const float* to, float t,
+                              float* out, std::size_t count,
+                              InterpolationKind kind = InterpolationKind::Auto);
+ValueRange<double>
+interpolate(const double* from, const double* to, double t, double* out,
+            std::size_t count,
+            InterpolationKind kind = InterpolationKind::Auto);
+ValueRange<long double>
+interpolate(const long double* from, const long double* to, long double t,
+            long double* out, std::size_t count,
+            InterpolationKind kind = InterpolationKind::Auto);
+
+// Whether the CPU can run the given kind of interpolation
+bool isInterpolationSupported(InterpolationKind kind);
+
+#endif
@@ -5,6 +5,7 @@
 #include "viszbase/math.hpp"
 #include "viszbase/shader.hpp"
 
+#include <memory>
 #include <vector>
 
 class LineRendererBuilder;
@@ -17,9 +18,11 @@ public:
 
 private:
     LineRenderer(std::vector<float>& points);
+    void setPoints(std::vector<float>& points);
 
     unsigned VAO, VBO, numOfPoints;
-    Shader lineShader;
+    // Shared by every line
+    std::shared_ptr<Shader> lineShader;
 
     friend class LineRendererBuilder;
 };
@@ -29,6 +32,8 @@ class LineRendererBuilder
 public:
     void addPoint(float x, float y);
     LineRenderer build();
+    // Gives an existing renderer these points instead, reusing its buffers
+    void rebuild(LineRenderer& renderer);
 
 private:
     std::vector<float> points;
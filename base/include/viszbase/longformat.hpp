@@ -0,0 +1,51 @@
+#ifndef LONG_FORMAT_HPP
+#define LONG_FORMAT_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "dataset.hpp"
+#include "stringpool.hpp"
+
+// The order categories end up in, when read from a long format file
+enum class CategoryOrder
+{
+    // The order each category was first seen in
+    FirstAppearance,
+    // Sorted, numerically if both categories are numbers
+    Sorted,
+};
+
+// Turns name,category,value triples (long format) into a dataset with a row
+// for each name and a column for each category (wide format), as they're
+// read in. Only the values are kept, so the memory used depends on the
+// number of names and categories rather than the number of triples
+class LongFormatPivot
+{
+public:
+    // A later value for the same name and category replaces the earlier one.
+    // A NaN value is treated as missing, the same as a blank cell
+    void add(std::string_view name, std::string_view category, Value value);
+
+    // Puts the categories in order and moves everything into the dataset,
+    // which keeps its layout. As with wide files, a name that has no value
+    // for a category carries its value from the category before, or is 0 if
+    // there is nothing before it. The pivot is left empty
+    void finish(CategoryOrder order, std::vector<std::string>& categories,
+                Dataset& dataset);
+
+private:
+    // A name's id is its row, and a category's id its column
+    StringPool names, categoryNames;
+    // A column of values for each category, indexed by the name's id.
+    // Values that haven't been given are NaN
+    std::vector<std::vector<Value>> columns;
+
+    // Long format files often give the same category many times in a row,
+    // so the last one is remembered
+    StringId lastCategory = 0;
+};
+
+#endif
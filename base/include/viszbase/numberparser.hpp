@@ -0,0 +1,33 @@
+#ifndef NUMBER_PARSER_HPP
+#define NUMBER_PARSER_HPP
+
+#include <locale>
+#include <string_view>
+#include <vector>
+
+// How numbers are written, e.g. 1,234.5 or 1.234,5
+struct NumberFormat
+{
+    char decimalPoint = '.';
+    // 0 if the digits aren't grouped
+    char thousandsSeparator = 0;
+
+    static NumberFormat fromLocale(const std::locale& locale);
+};
+
+// Works out the format from a sample of cells, such as the first few rows
+// of a file. Cells that could be read either way, like "1,234", don't decide
+// anything, and nor do those whose digits aren't grouped in threes, like
+// "1.5.5". If nothing decides the format then 'fallback' is returned
+NumberFormat detectNumberFormat(const std::vector<std::string_view>& cells,
+                                const NumberFormat& fallback);
+
+// Parses the number at the start of the text, ignoring leading whitespace.
+// Handles a sign, grouped digits, a decimal point, an exponent (1.5e3) and a
+// trailing percent sign, which is ignored so "12%" reads as 12. Reading stops
+// at the first character that can't be part of the number, and 0 is returned
+// if there is no number at all. Defined for float, double and long double
+template <typename T>
+T parseNumber(std::string_view text, const NumberFormat& format);
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef NUMBER_WRITER_HPP
+#define NUMBER_WRITER_HPP
+
+#include <array>
+#include <string_view>
+
+#include "numberparser.hpp"
+
+// Room for any number writeNumber writes
+using NumberBuffer = std::array<char, 128>;
+
+// Writes the number into 'buffer' with 'decimalPoints' digits after the
+// decimal point, up to 32, using the format's decimal point and grouping the
+// digits in threes. Returns the text written, which lives in the buffer.
+// Numbers too long to fit are written with an exponent instead. Doesn't
+// allocate, so it's fine to call for every label every frame
+std::string_view writeNumber(long double number, int decimalPoints,
+                             const NumberFormat& format, NumberBuffer& buffer);
+
+// The system locale's format, read from it the first time it's asked for
+const NumberFormat& getSystemNumberFormat();
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef PROGRAM_CACHE_HPP
+#define PROGRAM_CACHE_HPP
+
+#include <cstdint>
+#include <string>
+
+// Linked shader programs, kept in the user's cache directory as the binary
+// the driver built, so that later runs load them rather than compile the
+// GLSL again. Files are named after a hash of the sources and of the
+// driver's vendor, renderer and version strings. The driver can still turn
+// a binary down, then the program is compiled as normal and saved again
+class ProgramCache
+{
+public:
+    // The source of each stage, 'gsSource' is null when there isn't a
+    // geometry shader. Needs the OpenGL context to be current
+    ProgramCache(const char* vsSource, const char* gsSource,
+                 const char* fsSource);
+
+    // Whether the cache is turned on and the driver can hand out program
+    // binaries
+    static bool isAvailable();
+    // On to start with. Turned off, programs are always compiled
+    static void setEnabled(bool enabled);
+
+    // Call before linking a program that will be saved, so the driver
+    // keeps its binary
+    static void prepare(unsigned program);
+
+    // Loads the cached binary into the program, which has nothing attached.
+    // Returns false if there isn't a cache file, it doesn't match, or the
+    // driver wouldn't take it, and the program is left unlinked
+    bool load(unsigned program) const;
+
+    // Writes the linked program's binary, replacing any cache file already
+    // there. Returns false if it couldn't be got or written
+    bool save(unsigned program) const;
+
+    // In the cache directory, and named *.nvzprogram
+    const std::string& getPath() const { return path; }
+
+private:
+    std::string path;
+    std::uint64_t sourceHash;
+    std::uint64_t driverHash;
+};
+
+#endif
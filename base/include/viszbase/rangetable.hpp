@@ -0,0 +1,33 @@
+#ifndef RANGE_TABLE_HPP
+#define RANGE_TABLE_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "dataset.hpp"
+#include "interpolation.hpp"
+
+// The lowest and highest value of any row over the categories from the first
+// up to any one, looked up in constant time. Kept as a running range over the
+// categories, built when the data is loaded, so a chart can scale its axis to
+// exactly what's shown at any time, going forwards or backwards
+class RangeTable
+{
+public:
+    RangeTable() = default;
+    // The dataset has to be category major
+    explicit RangeTable(const Dataset& dataset);
+
+    // Takes in the rows added to the end of the dataset, from 'firstRow' on
+    void addRows(const Dataset& dataset, std::size_t firstRow);
+
+    // The range over categories 0 to 'last', including both. With no rows or
+    // no categories, lowest is infinity and highest is minus infinity
+    ValueRange<Value> getRange(std::size_t last) const;
+
+private:
+    // prefixes[c] is the range over categories 0 to c
+    std::vector<ValueRange<Value>> prefixes;
+};
+
+#endif
@@ -0,0 +1,165 @@
+#ifndef RANKING_HPP
+#define RANKING_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <vector>
+
+#include "threadpool.hpp"
+
+// Once insertion sort has made this many swaps for each entry, merge sort is
+// quicker for the rest
+constexpr std::size_t MaxInsertionSwapsPerEntry = 16;
+
+// Merges the sorted runs [first, middle) and [middle, last) into 'out',
+// returning the number of pairs that were out of order
+template <typename T, typename Less>
+std::size_t mergeRuns(const T* first, const T* middle, const T* last, T* out,
+                      Less less)
+{
+    std::size_t swaps = 0;
+    const T *a = first, *b = middle;
+    while (a < middle && b < last)
+    {
+        // Taking from the second run means passing over everything left in
+        // the first
+        if (less(*b, *a))
+        {
+            swaps += middle - a;
+            *out++ = *b++;
+        }
+        else
+            *out++ = *a++;
+    }
+    out = std::copy(a, middle, out);
+    std::copy(b, last, out);
+    return swaps;
+}
+
+// Merge sorts [first, last), returning the number of pairs that were out of
+// order
+template <typename T, typename Less>
+std::size_t countingMergeSort(T* first, T* last, Less less)
+{
+    std::size_t size = last - first;
+    std::size_t swaps = 0;
+    std::vector<T> buffer(size);
+    T* in = first;
+    T* out = buffer.data();
+    for (std::size_t width = 1; width < size; width *= 2)
+    {
+        for (std::size_t low = 0; low < size; low += 2 * width)
+        {
+            std::size_t middle = std::min(low + width, size);
+            std::size_t high = std::min(low + 2 * width, size);
+            swaps += mergeRuns(in + low, in + middle, in + high, out + low,
+                               less);
+        }
+        std::swap(in, out);
+    }
+    if (in != first)
+        std::copy(in, in + size, first);
+    return swaps;
+}
+
+// Sorts [first, last) again after the values it's sorted by have changed,
+// returning how many times 2 neighbouring entries swapped places. 'less'
+// must never find 2 entries equal. Values that change a little at a time, as
+// they do from one frame to the next, only move a few entries a few places,
+// so this takes time that depends on how much has changed rather than the
+// size
+template <typename T, typename Less>
+std::size_t reorder(T* first, T* last, Less less)
+{
+    if (first == last)
+        return 0;
+    const std::size_t maxSwaps = (last - first) * MaxInsertionSwapsPerEntry;
+
+    std::size_t swaps = 0;
+    for (T* i = first + 1; i < last; i++)
+    {
+        T entry = *i;
+        T* j = i;
+        for (; j > first && less(entry, *(j - 1)); j--)
+            *j = *(j - 1);
+        *j = entry;
+        swaps += i - j;
+
+        // Each swap puts one pair in order, so the pairs still out of order
+        // make up the rest of the swaps
+        if (swaps > maxSwaps)
+            return swaps + countingMergeSort(first, last, less);
+    }
+    return swaps;
+}
+
+template <typename T, typename Less>
+std::size_t reorder(std::vector<T>& order, Less less)
+{
+    return reorder(order.data(), order.data() + order.size(), less);
+}
+
+// Merges the neighbouring sorted runs [first, middle) and [middle, last),
+// returning the number of pairs that were out of order. Only the entries out
+// of order with the other run are moved, which is few of them when the runs
+// were cut from an order that has only changed a little
+template <typename T, typename Less>
+std::size_t mergeNeighbours(T* first, T* middle, T* last, Less less)
+{
+    if (first == middle || middle == last)
+        return 0;
+    // Those before the first run's first entry above the second run, and
+    // those after the second run's last entry below the first, are in place
+    T* from = std::upper_bound(first, middle, *middle, less);
+    T* to = std::lower_bound(middle, last, *(middle - 1), less);
+    if (from == middle)
+        return 0;
+
+    std::vector<T> merged(to - from);
+    std::size_t swaps = mergeRuns<T>(from, middle, to, merged.data(), less);
+    std::copy(merged.begin(), merged.end(), from);
+    return swaps;
+}
+
+// The same as reorder, but splits 'order' into 'parts' runs which are each
+// reordered on their own thread, then merged. Gives the same order and swap
+// count as reordering it all at once
+template <typename T, typename Less>
+std::size_t reorder(ThreadPool& pool, std::size_t parts,
+                    std::vector<T>& order, Less less)
+{
+    if (parts <= 1)
+        return reorder(order, less);
+
+    std::vector<std::size_t> bounds(parts + 1);
+    for (std::size_t p = 0; p <= parts; p++)
+        bounds[p] = order.size() * p / parts;
+    T* data = order.data();
+
+    std::vector<std::size_t> swaps(parts);
+    pool.run(parts,
+             [&](std::size_t p)
+             {
+                 swaps[p] =
+                     reorder(data + bounds[p], data + bounds[p + 1], less);
+             });
+
+    // Merge neighbouring runs in pairs, halving the number of runs each time
+    for (std::size_t width = 1; width < parts; width *= 2)
+    {
+        pool.run((parts + 2 * width - 1) / (2 * width),
+                 [&](std::size_t pair)
+                 {
+                     std::size_t low = pair * 2 * width;
+                     std::size_t middle = std::min(low + width, parts);
+                     std::size_t high = std::min(low + 2 * width, parts);
+                     swaps[low] += mergeNeighbours(data + bounds[low],
+                                                   data + bounds[middle],
+                                                   data + bounds[high], less);
+                 });
+    }
+    return std::accumulate(swaps.begin(), swaps.end(), std::size_t(0));
+}
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef RANK_TIMELINE_HPP
+#define RANK_TIMELINE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "dataset.hpp"
+
+// An index of which rows can be among the highest between each category and
+// the next. The charts move a row's value in a straight line from one
+// category to the next, so in between it never goes below the lower of the
+// two values, or above the higher. If 'depth' rows never go below some value
+// then a row that never goes above it can't be in the top 'depth', so it
+// isn't a candidate. Built when the data is loaded, so that each frame only
+// has to look at the candidates rather than every row
+class RankTimeline
+{
+public:
+    RankTimeline() = default;
+    // The dataset has to be category major. The intervals between categories
+    // are spread over 'threads' threads, 0 uses one per hardware thread
+    RankTimeline(const Dataset& dataset, std::size_t depth,
+                 unsigned threads = 0);
+
+    // Takes in the rows added to the end of the dataset, from 'firstRow' on.
+    // Only the new rows are looked at, unless the number of rows has doubled
+    // since it was built, then it's built again
+    void addRows(const Dataset& dataset, std::size_t firstRow);
+
+    std::size_t getDepth() const { return depth; }
+    std::size_t getIntervalCount() const { return intervals.size(); }
+
+    // The rows that could be in the top 'depth' at some point between
+    // 'category' and the category after it, highest at 'category' first. At
+    // any point in between, the top 'depth' of the candidates are the same
+    // as the top 'depth' of all the rows
+    const std::vector<std::uint32_t>& getCandidates(std::size_t category) const
+    {
+        return intervals[category].candidates;
+    }
+
+private:
+    struct Interval
+    {
+        // 'depth' rows are at or above this for the whole of the interval
+        Value floor;
+        std::vector<std::uint32_t> candidates;
+    };
+
+    std::size_t depth = 0;
+    unsigned threads = 0;
+    std::size_t builtRowCount = 0;
+    std::vector<Interval> intervals;
+
+    void build(const Dataset& dataset);
+    void buildInterval(const Dataset& dataset, std::size_t category);
+    // The first 'sorted' candidates are already in order
+    void sortCandidates(const Dataset& dataset, std::size_t category,
+                        std::size_t sorted = 0);
+};
+
+#endif
@@ -1,6 +1,9 @@
 #ifndef RENDERER_HPP
 #define RENDERER_HPP
 
+#include <memory>
+#include <vector>
+
 #include "shader.hpp"
 #include "math.hpp"
 
@@ -11,15 +14,30 @@ class Renderer
 public:
     Renderer();
 
+    // Draws a box straight away
     void drawBox(float x, float y, float x1, float y1, Color color,
                  math::Matrix<4, 4>& projection);
 
+    // Queues a box to be drawn by the next flush, so that many boxes can be
+    // drawn with a single draw call
+    void queueBox(float x, float y, float x1, float y1, Color color);
+    // Draws the queued boxes in the order they were queued, then empties the
+    // queue
+    void flush(const math::Matrix<4, 4>& projection);
+
 private:
-    unsigned VAO, VBO;
-    Shader rectShader;
+    // What the shader gets for each box
+    struct Box
+    {
+        float x, y, width, height;
+        Color color;
+    };
+
+    unsigned VAO, VBO, instanceVBO;
+    // How many boxes the instance buffer has room for
+    std::size_t instanceCapacity = 0;
+    std::shared_ptr<Shader> rectShader;
 
-    math::Matrix<4, 4> translate;
-    math::Matrix<4, 4> scale;
-    math::Matrix<4, 4> result;
+    std::vector<Box> boxes;
 };
 #endif
@@ -1,6 +1,7 @@
 #ifndef SHADER_HPP
 #define SHADER_HPP
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 
@@ -9,6 +10,11 @@ class Shader
 public:
     Shader(const char* vsSource, const char* fsSource);
     Shader(const char* vsSource, const char* gsSource, const char* fsSource);
+    ~Shader();
+
+    Shader(const Shader&) = delete;
+    Shader& operator=(const Shader&) = delete;
+
     unsigned getUniformLocation(const std::string&);
 
     unsigned getProgram() { return program; }
@@ -20,7 +26,37 @@ private:
     std::unordered_map<std::string, unsigned int> uniformLocations;
     std::string errorMsg;
 
+    // Loads the program from the program cache if it can, otherwise
+    // compiles and links it, then saves it there
+    void build(const char* vsSource, const char* gsSource,
+               const char* fsSource);
     unsigned createShader(unsigned shaderType, const char* source);
 };
 
+// Hands out one program for each set of shader sources, so every renderer
+// drawing the same way shares it rather than compiling its own. Programs
+// belong to the OpenGL context they were made in, and there's only the one.
+// Isn't thread safe, shaders are only made on the thread drawing with them
+class ShaderRegistry
+{
+public:
+    static ShaderRegistry& getInstance();
+
+    ShaderRegistry(const ShaderRegistry&) = delete;
+    ShaderRegistry& operator=(const ShaderRegistry&) = delete;
+
+    // Compiles the program the first time it's asked for. Check its error
+    // message, a program that failed is handed out the same as one that
+    // didn't
+    std::shared_ptr<Shader> get(const char* vsSource, const char* fsSource);
+    std::shared_ptr<Shader> get(const char* vsSource, const char* gsSource,
+                                const char* fsSource);
+
+private:
+    // By the sources, only kept while the program is in use
+    std::unordered_map<std::string, std::weak_ptr<Shader>> programs;
+
+    ShaderRegistry() = default;
+};
+
 #endif
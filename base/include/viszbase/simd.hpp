@@ -0,0 +1,39 @@
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+// Which SIMD instructions can be compiled in, for the code that has versions
+// using them. Brings in the intrinsics, so only include it in source files
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) ||           \
+    defined(_M_IX86)
+#define VISZBASE_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// SSE2 is always there on 64 bit x86, only use it on 32 bit if it was
+// enabled for the whole build
+#if defined(VISZBASE_X86) &&                                                  \
+    (defined(__SSE2__) || defined(_M_X64) ||                                   \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define VISZBASE_SSE2
+#endif
+
+// AVX2 has to be checked for at runtime, so it gets compiled in just for
+// the functions that use it
+#if defined(VISZBASE_X86) && (defined(__GNUC__) || defined(_MSC_VER))
+#define VISZBASE_AVX2
+#ifdef __GNUC__
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+#endif
+
+// Whether the CPU, and the OS, can run AVX2 instructions. Always false when
+// they can't be compiled in
+bool cpuHasAVX2();
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef STRING_POOL_HPP
+#define STRING_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+using StringId = std::uint32_t;
+
+// Keeps one copy of each distinct string added to it, packed end to end in
+// large blocks rather than allocated one at a time. Each string is given an
+// id, in the order they're first added, starting at 0. The string_views it
+// gives out stay valid for as long as the pool does, even when more strings
+// are added or the pool is moved
+class StringPool
+{
+public:
+    StringPool() = default;
+    StringPool(StringPool&&) = default;
+    StringPool& operator=(StringPool&&) = default;
+
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    // Gets the id of the string, adding it to the pool if it isn't there
+    StringId intern(std::string_view str);
+    // Gets the id of the string without adding it, returns false if it
+    // isn't in the pool
+    bool find(std::string_view str, StringId& id) const;
+
+    // Followed by a null character, as with std::string
+    std::string_view get(StringId id) const { return strings[id]; }
+    std::size_t size() const { return strings.size(); }
+
+    // Bytes of memory allocated for the strings and for finding them
+    std::size_t getMemoryUsage() const;
+
+private:
+    std::vector<std::unique_ptr<char[]>> blocks;
+    std::size_t blocksSize = 0;
+    // The space left in the block being filled
+    char* nextFree = nullptr;
+    std::size_t freeSize = 0;
+
+    std::vector<std::string_view> strings;
+    // A hash table of the ids, found by probing from the string's hash
+    // until an empty slot. Kept at most half full
+    std::vector<StringId> slots;
+
+    const char* store(std::string_view str);
+    // The slot the string's id is in, or the empty slot it would go in
+    std::size_t findSlot(std::string_view str) const;
+    void growSlots();
+};
+
+#endif
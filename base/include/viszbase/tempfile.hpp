@@ -0,0 +1,12 @@
+#ifndef TEMP_FILE_HPP
+#define TEMP_FILE_HPP
+
+#include <string>
+
+// A name for a temporary file next to 'path', to write to and then rename to
+// 'path' so the file there is always complete. Made from the process id and
+// a random number, so processes writing the same file at once each write
+// their own
+std::string getTempPath(const std::string& path);
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads that parallel loops are spread across
+class ThreadPool
+{
+public:
+    // A thread count of 0 uses one thread per hardware thread. The calling
+    // thread counts as one of the threads. The others aren't started until
+    // there's more than one task to run, so a pool that never gets one costs
+    // nothing
+    explicit ThreadPool(unsigned threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned getThreadCount() const { return threadCount; }
+
+    // Calls task(i) for every i in [0, count), spread over the workers and
+    // the calling thread, and returns once all of them have finished. The
+    // first exception thrown by a task is rethrown here
+    void run(std::size_t count, const std::function<void(std::size_t)>& task);
+    // Takes any callable, and only makes a std::function of it when there's
+    // more than one thread to run it on, so work that's often too small to
+    // split can go through the pool for free
+    template <typename Task> void run(std::size_t count, const Task& task)
+    {
+        if (threadCount <= 1 || count <= 1)
+        {
+            for (std::size_t i = 0; i < count; i++)
+                task(i);
+            return;
+        }
+        run(count, std::function<void(std::size_t)>(task));
+    }
+
+private:
+    unsigned threadCount;
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    // State of the current run, only changed while no worker is active
+    const std::function<void(std::size_t)>* task = nullptr;
+    std::size_t count = 0;
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::size_t> finished{0};
+    std::exception_ptr error;
+
+    unsigned generation = 0;
+    unsigned activeWorkers = 0;
+    bool stopping = false;
+
+    void workerLoop();
+    void work(const std::function<void(std::size_t)>& runTask,
+              std::size_t runCount);
+};
+
+#endif
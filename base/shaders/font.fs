@@ -8,6 +8,8 @@ uniform sampler2D tex;
 out vec4 outColor;
 
 void main() {
-  outColor = vec4(0.0f, 0.0f, 0.0f, texture(tex, vec2(textureCoord.x, 1-textureCoord.y)).r);
+  // The coordinate is in pixels, as the atlas page can grow
+  vec2 coord = textureCoord / vec2(textureSize(tex, 0));
+  outColor = vec4(0.0f, 0.0f, 0.0f, texture(tex, coord).r);
 }
 )"
@@ -3,6 +3,10 @@ R"(
 
 layout (location = 0) in vec3 position;
 layout (location = 1) in vec2 texCoord;
+// One of each per character, where it goes on screen, and where its bitmap
+// is in the atlas page in pixels
+layout (location = 2) in vec4 glyph;
+layout (location = 3) in vec4 glyphTexture;
 
 out vec2 textureCoord;
 
@@ -10,7 +14,10 @@ uniform mat4 matrix;
 
 void main()
 {
-  textureCoord = texCoord;
-  gl_Position = matrix * vec4(position, 1.0);
+  // The bitmap's first row is its top, and screen y goes down
+  textureCoord = glyphTexture.xy +
+                 vec2(texCoord.x, 1 - texCoord.y) * glyphTexture.zw;
+  gl_Position =
+    matrix * vec4(glyph.xy + position.xy * glyph.zw, position.z, 1.0);
 }
 )"
@@ -0,0 +1,21 @@
+R"(
+#version 330 core
+
+in vec2 textureCoord;
+
+// How far each pixel is from the edge of the character, 0.5 on the edge and
+// higher inside it
+uniform sampler2D tex;
+
+out vec4 outColor;
+
+void main() {
+  // The coordinate is in pixels, as the atlas page can grow
+  vec2 coord = textureCoord / vec2(textureSize(tex, 0));
+  float distance = texture(tex, coord).r;
+  // Blend across about a pixel on screen, whatever size it's drawn at
+  float smoothing = fwidth(distance) * 0.5;
+  float alpha = smoothstep(0.5 - smoothing, 0.5 + smoothing, distance);
+  outColor = vec4(0.0f, 0.0f, 0.0f, alpha);
+}
+)"
@@ -1,7 +1,7 @@
 R"(
 #version 330 core
 
-uniform vec4 color;
+in vec4 color;
 out vec4 outColor;
 
 void main() {
@@ -2,11 +2,18 @@ R"(
 #version 330 core
 
 layout (location = 0) in vec3 position;
+// One of each per box, its corner and size, and its color
+layout (location = 1) in vec4 box;
+layout (location = 2) in vec4 boxColor;
 
 uniform mat4 matrix;
 
+out vec4 color;
+
 void main()
 {
-  gl_Position = matrix * vec4(position, 1.0);
+  color = boxColor;
+  gl_Position =
+    matrix * vec4(box.xy + position.xy * box.zw, position.z, 1.0);
 }
 )"
@@ -0,0 +1,24 @@
+#include "viszbase/cachedirectory.hpp"
+
+#include <cstdlib>
+
+std::filesystem::path getCacheDirectory()
+{
+    std::filesystem::path directory;
+#ifdef _WIN32
+    if (const char* localAppData = std::getenv("LOCALAPPDATA"))
+        directory = std::filesystem::path(localAppData) / "numvisz" / "cache";
+#else
+    const char* cacheHome = std::getenv("XDG_CACHE_HOME");
+    const char* home = std::getenv("HOME");
+    if (cacheHome && *cacheHome)
+        directory = std::filesystem::path(cacheHome) / "numvisz";
+    else if (home && *home)
+        directory = std::filesystem::path(home) / ".cache" / "numvisz";
+#endif
+    std::error_code error;
+    if (directory.empty())
+        directory = std::filesystem::temp_directory_path(error) / "numvisz";
+    std::filesystem::create_directories(directory, error);
+    return directory;
+}
@@ -1,135 +1,630 @@
 #include "viszbase/csvparser.hpp"
 
 #include <string>
+#include <string_view>
 #include <fstream>
+#include <sstream>
 #include <algorithm>
+#include <exception>
+#include <limits>
 #include <locale>
-#include <sstream>
+#include <memory>
+#include <stdexcept>
+
+#include "viszbase/csvscanner.hpp"
+#include "viszbase/filewatcher.hpp"
+#include "viszbase/mappedfile.hpp"
+#include "viszbase/numberparser.hpp"
+#include "viszbase/threadpool.hpp"
 
-CsvParser::CsvParser(const std::string& fileName)
+namespace
 {
-    std::ifstream csvFile(fileName);
-    std::string line;
+// Each thread is given at least this many bytes of rows to parse, below this
+// the cost of starting the threads outweighs the time saved
+constexpr std::size_t MinChunkSize = 1 << 20;
 
-    std::istringstream is;
-    is.imbue(std::locale(""));
+// Number of rows looked at to work out how the numbers are written
+constexpr int FormatSampleRows = 100;
 
-    if (!csvFile.is_open())
-        throw std::runtime_error("Failed to open CSV file");
+// When following a file, this much of the end of what was read is kept to
+// check it hasn't changed when more is added
+constexpr std::size_t TailCheckSize = 4096;
 
-    try
+// The contents of a file, either mapped or read into memory
+class FileContents
+{
+public:
+    // If it can't be mapped (e.g. it's a pipe) then it's read instead
+    FileContents(const std::string& fileName, bool memoryMap)
+    {
+        if (memoryMap)
+        {
+            try
+            {
+                mappedFile = std::make_unique<MappedFile>(fileName);
+                return;
+            }
+            catch (std::runtime_error&)
+            {
+            }
+        }
+
+        std::ifstream csvFile(fileName, std::ios::binary);
+        if (!csvFile.is_open())
+            throw std::runtime_error("Failed to open CSV file");
+
+        std::ostringstream os;
+        os << csvFile.rdbuf();
+        contents = os.str();
+    }
+
+    std::string_view getView() const
     {
-        std::string::iterator it, prevIt;
+        return mappedFile ? mappedFile->getView() : std::string_view(contents);
+    }
 
-        // Read in the categories row
-        std::getline(csvFile, line);
+private:
+    std::unique_ptr<MappedFile> mappedFile;
+    std::string contents;
+};
 
-        // Read in the title, bearing in mind it could be in double quotes
-        if (*line.begin() == '"')
+// Walks through the cells of the record (line) starting at 'pos'. A cell in
+// double quotes runs to the closing quotation mark, which may be on a later
+// line, and otherwise it runs to the next comma or newline. The record ends
+// at the first newline that isn't inside a quoted cell
+class CellReader
+{
+public:
+    CellReader(CsvScanner& scanner, std::string_view data, std::size_t pos)
+        : scanner{scanner}, data{data}, pos{pos}
+    {
+    }
+
+    // Gets the next cell of the record, returns false once it has run out.
+    // Every record has at least one cell, even if it is empty
+    bool next(std::string_view& cell)
+    {
+        if (recordDone)
+            return false;
+
+        std::size_t sep;
+        // If theres a quotation mark present, look for the closing quotation
+        // mark, not a comma, and then add 1 to get to the comma after it
+        if (pos < data.size() && data[pos] == '"')
         {
-            it = std::find(line.begin() + 1, line.end(), '"');
-            name = std::string(line.begin() + 1, it);
-            prevIt = it + 1;
+            std::size_t close = scanner.findQuote(pos + 1);
+            cell = data.substr(pos + 1, close - pos - 1);
+            sep = close + 1;
         }
         else
         {
-            it = std::find(line.begin(), line.end(), ',');
-            name = std::string(line.begin(), it);
-            prevIt = it;
+            sep = scanner.findSeparator(pos);
+            cell = data.substr(pos, sep - pos);
         }
 
-        // Read in the categories, accounting for double quotes
-        while (it != line.end())
+        if (sep >= data.size())
         {
-            // If theres a quotation mark present, look for the closing
-            // quotation mark, not a comma, and then add 1 to get to the
-            // comma after it (or line.end())
-            std::string category;
-            if ((prevIt + 1) != line.end() && *(prevIt + 1) == '"')
-            {
-                it = 1 + std::find(prevIt + 2, line.end(), '"');
-                category = std::string(prevIt + 2, it - 1);
-            }
-            else
-            {
-                it = std::find(prevIt + 1, line.end(), ',');
-                category = std::string(prevIt + 1, it);
-            }
+            recordDone = true;
+            pos = data.size();
+        }
+        else
+        {
+            recordDone = (data[sep] == '\n');
+            pos = sep + 1;
+        }
+        return true;
+    }
+
+    // Skips over the rest of the record
+    void skipRecord()
+    {
+        std::string_view cell;
+        while (next(cell))
+            ;
+    }
+
+    // Once the record has been read, this is the start of the next one
+    std::size_t getPosition() const { return pos; }
+
+private:
+    CsvScanner& scanner;
+    std::string_view data;
+    std::size_t pos;
+    bool recordDone = false;
+};
+
+// Read in the title and the categories from the first record, returns the
+// position the rows start at
+std::size_t parseHeader(CsvScanner& scanner, std::string_view data,
+                        std::string& name,
+                        std::vector<std::string>& categories)
+{
+    CellReader reader(scanner, data, 0);
+
+    std::string_view cell;
+    reader.next(cell);
+    name = std::string(cell);
+
+    while (reader.next(cell))
+    {
+        if (cell.empty())
+            throw std::exception();
+        categories.emplace_back(cell);
+    }
+    return reader.getPosition();
+}
+
+// Rows parsed into a single block of values, row major. The names are left
+// in the file's contents until they're added to the dataset
+struct RowBlock
+{
+    std::vector<std::string_view> names;
+    std::vector<Value> values;
+};
+
+// Read in a row's name and values, rows with no name are skipped. Every row
+// gets a value for each category, if it's short then the missing cells are
+// treated as blank, and if it's long then the extra cells are ignored.
+// Returns the position of the next row
+std::size_t parseRow(CsvScanner& scanner, std::string_view data,
+                     std::size_t pos, const NumberFormat& format,
+                     std::size_t categoryCount, RowBlock& rows)
+{
+    CellReader reader(scanner, data, pos);
+
+    std::string_view cell;
+    reader.next(cell);
+    if (cell.empty())
+    {
+        reader.skipRecord();
+        return reader.getPosition();
+    }
+
+    rows.names.push_back(cell);
+
+    std::size_t first = rows.values.size();
+    for (std::size_t i = 0; i < categoryCount; i++)
+    {
+        if (reader.next(cell) && !cell.empty())
+            rows.values.push_back(parseNumber<Value>(cell, format));
+        else if (i == 0)
+            // If the value is blank, i.e. 2 adjacent commas, enter 0
+            rows.values.push_back(0);
+        else
+            rows.values.push_back(rows.values[first + i - 1]);
+    }
+    reader.skipRecord();
+    return reader.getPosition();
+}
 
-            if (!category.empty())
-                categories.push_back(category);
-            else
-                throw std::exception();
+// Rows parsed from one chunk of the file
+struct Chunk
+{
+    std::size_t begin, end;
+    // Where parsing actually stopped. A row that starts before 'end' is
+    // always finished, even if a quoted cell carries it on past 'end'
+    std::size_t stoppedAt;
+    RowBlock rows;
+    std::exception_ptr error;
+};
+
+void parseChunk(std::string_view data, CsvScannerKind scannerKind,
+                const NumberFormat& format, std::size_t categoryCount,
+                Chunk& chunk)
+{
+    chunk.rows = RowBlock();
+    chunk.stoppedAt = chunk.begin;
+    chunk.error = nullptr;
+    try
+    {
+        CsvScanner scanner(data, scannerKind);
+
+        std::size_t pos = chunk.begin;
+        while (pos < chunk.end)
+            pos = parseRow(scanner, data, pos, format, categoryCount,
+                           chunk.rows);
+        chunk.stoppedAt = pos;
+    }
+    catch (...)
+    {
+        chunk.error = std::current_exception();
+    }
+}
+
+// The settings that change the values parsed from a file, a cache file is
+// only used if they're the same as when it was written
+std::string getCacheSettings(const CsvOptions& options)
+{
+    std::string settings;
+    if (options.tableFormat == TableFormat::Long)
+        settings = (options.categoryOrder == CategoryOrder::Sorted)
+                       ? "long,sorted,"
+                       : "long,";
+    if (!options.numberFormat)
+        return settings + "auto";
+    return settings + std::string{'f', options.numberFormat->decimalPoint,
+                                  options.numberFormat->thousandsSeparator};
+}
+
+// Works out how the numbers are written from the cells of the first rows,
+// if it can't be told from them then the system's locale is used. The first
+// 'skipCells' of each row aren't numbers, so they're left out
+NumberFormat detectFormat(CsvScanner& scanner, std::string_view data,
+                          std::size_t pos, int skipCells = 1)
+{
+    std::vector<std::string_view> cells;
+    for (int row = 0; row < FormatSampleRows && pos < data.size(); row++)
+    {
+        CellReader reader(scanner, data, pos);
+
+        std::string_view cell;
+        for (int i = 0; i < skipCells; i++)
+            reader.next(cell);
+        while (reader.next(cell))
+            cells.push_back(cell);
+        pos = reader.getPosition();
+    }
+    return detectNumberFormat(cells,
+                              NumberFormat::fromLocale(std::locale("")));
+}
+
+// Read in the header of a long format file, the heading of the values
+// column is used as the title. Returns the position the rows start at
+std::size_t parseLongHeader(CsvScanner& scanner, std::string_view data,
+                            std::string& name)
+{
+    CellReader reader(scanner, data, 0);
+
+    std::string_view cell;
+    for (int i = 0; i < 3 && reader.next(cell); i++)
+        name = std::string(cell);
+    reader.skipRecord();
+    return reader.getPosition();
+}
+
+// Reads the name, category and value of each row of a long format file into
+// the pivot. Rows with no name or category are skipped, and a blank value is
+// filled in as a blank cell in a wide file would be
+void parseLongRows(CsvScanner& scanner, std::string_view data,
+                   std::size_t pos, const NumberFormat& format,
+                   LongFormatPivot& pivot)
+{
+    std::string_view rowName, category, value;
+    while (pos < data.size())
+    {
+        CellReader reader(scanner, data, pos);
+        bool complete = reader.next(rowName) && reader.next(category) &&
+                        reader.next(value);
+        reader.skipRecord();
+        pos = reader.getPosition();
+
+        if (!complete || rowName.empty() || category.empty())
+            continue;
+        pivot.add(rowName, category,
+                  value.empty() ? std::numeric_limits<Value>::quiet_NaN()
+                                : parseNumber<Value>(value, format));
+    }
+}
 
-            prevIt = it;
+// Parses the rows from 'begin' to the end of the data into the dataset. The
+// rows are split into chunks at newlines, and each chunk is parsed on its
+// own thread
+void parseRows(std::string_view data, std::size_t begin,
+               const CsvOptions& options, const NumberFormat& format,
+               Dataset& dataset)
+{
+    std::size_t categoryCount = dataset.getCategoryCount();
+
+    ThreadPool pool(options.threads);
+    std::size_t chunkCount = std::min<std::size_t>(
+        pool.getThreadCount(), (data.size() - begin) / MinChunkSize);
+    chunkCount = std::max<std::size_t>(chunkCount, 1);
+
+    // Space the chunks out evenly, then move each boundary up to the start
+    // of the next line
+    std::vector<Chunk> chunks(chunkCount);
+    for (std::size_t i = 0; i < chunkCount; i++)
+    {
+        std::size_t boundary = begin + (data.size() - begin) * i / chunkCount;
+        if (i > 0 && data[boundary - 1] != '\n')
+            boundary = std::min(data.find('\n', boundary), data.size() - 1) + 1;
+        chunks[i].begin = boundary;
+    }
+    for (std::size_t i = 0; i < chunkCount; i++)
+    {
+        chunks[i].end =
+            (i + 1 < chunkCount) ? chunks[i + 1].begin : data.size();
+        chunks[i].begin = std::min(chunks[i].begin, chunks[i].end);
+    }
+
+    pool.run(chunkCount,
+             [&](std::size_t i)
+             {
+                 parseChunk(data, options.scanner, format, categoryCount,
+                            chunks[i]);
+             });
+
+    // A chunk is only right if the chunk before it stopped exactly where it
+    // begins. If not, the newline it began after was inside a quoted cell,
+    // so parse it again from where the last row before it really ended
+    for (std::size_t i = 1; i < chunkCount; i++)
+    {
+        std::size_t expected = chunks[i - 1].stoppedAt;
+        if (chunks[i].begin != expected)
+        {
+            chunks[i].begin = expected;
+            chunks[i].end = std::max(chunks[i].end, expected);
+            parseChunk(data, options.scanner, format, categoryCount,
+                       chunks[i]);
         }
+    }
 
-        // Read in each row
-        while (std::getline(csvFile, line))
+    // Merge the rows in file order
+    std::size_t total = 0;
+    for (auto& chunk : chunks)
+    {
+        if (chunk.error)
+            std::rethrow_exception(chunk.error);
+        total += chunk.rows.names.size();
+    }
+    // Make room for all of them at once, unless they're being added to rows
+    // already there, then let the dataset grow as it would usually
+    if (dataset.getRowCount() == 0)
+        dataset.reserveRows(total);
+    for (auto& chunk : chunks)
+    {
+        dataset.appendRows(chunk.rows.names, chunk.rows.values);
+        chunk.rows = RowBlock();
+    }
+}
+} // namespace
+
+CsvOptions CsvOptions::fromArguments(const Arguments& args)
+{
+    CsvOptions options;
+
+    std::string decimalPoint = args.get("-decimalseparator");
+    std::string thousandsSeparator = args.get("-thousandsseparator");
+    if (decimalPoint != Arguments::NotSet ||
+        thousandsSeparator != Arguments::NotSet)
+    {
+        NumberFormat format;
+        if (decimalPoint != Arguments::NotSet)
         {
-            Row r;
+            if (decimalPoint.size() != 1)
+                throw std::runtime_error("Decimal separator must be a single "
+                                         "character");
+            format.decimalPoint = decimalPoint[0];
+        }
+        if (thousandsSeparator != Arguments::NotSet &&
+            thousandsSeparator != "none")
+        {
+            if (thousandsSeparator.size() != 1)
+                throw std::runtime_error("Thousands separator must be a "
+                                         "single character, or none");
+            format.thousandsSeparator = thousandsSeparator[0];
+        }
+        options.numberFormat = format;
+    }
 
-            // Read in the title, accounting for quotation marks
-            if (*line.begin() == '"')
-            {
-                it = 1 + std::find(line.begin() + 1, line.end(), '"');
-                r.name = std::string(line.begin() + 1, it - 1);
-            }
-            else
-            {
-                it = std::find(line.begin(), line.end(), ',');
-                r.name = std::string(line.begin(), it);
-            }
+    std::string follow = args.get("-follow", "off");
+    if (follow == "on")
+        options.follow = true;
+    else if (follow != "off")
+        throw std::runtime_error("Follow must be on or off");
+
+    std::string tableFormat = args.get("-format", "wide");
+    if (tableFormat == "wide")
+        options.tableFormat = TableFormat::Wide;
+    else if (tableFormat == "long")
+        options.tableFormat = TableFormat::Long;
+    else
+        throw std::runtime_error("Format must be wide or long");
+
+    std::string categoryOrder = args.get("-categoryorder", "appearance");
+    if (categoryOrder == "appearance")
+        options.categoryOrder = CategoryOrder::FirstAppearance;
+    else if (categoryOrder == "sorted")
+        options.categoryOrder = CategoryOrder::Sorted;
+    else
+        throw std::runtime_error("Category order must be appearance or sorted");
 
-            // If the row's first column is empty, skip the row
-            if (r.name.empty())
-                continue;
+    std::string cache = args.get("-cache", "on");
+    if (cache == "on")
+        options.cache = CacheMode::On;
+    else if (cache == "off")
+        options.cache = CacheMode::Off;
+    else if (cache == "rebuild")
+        options.cache = CacheMode::Rebuild;
+    else
+        throw std::runtime_error("Cache must be on, off or rebuild");
+
+    return options;
+}
 
-            // Read in the values
-            auto prevIt = it;
-            while (it != line.end())
+CsvParser::CsvParser(const std::string& fileName, const CsvOptions& options)
+    : fileName{fileName}, options{options}
+{
+    // Start watching before reading, so that nothing written while the file
+    // is being read is missed
+    if (options.follow)
+        watcher = std::make_unique<FileWatcher>(fileName);
+
+    FileContents file(fileName, options.memoryMap);
+    parse(getCompleteLines(file.getView()), options.cache);
+}
+
+CsvParser::Change CsvParser::update()
+{
+    replacedDataset = Dataset();
+    if (!watcher || !watcher->hasChanged())
+        return Change::None;
+
+    std::unique_ptr<FileContents> file;
+    try
+    {
+        file = std::make_unique<FileContents>(fileName, options.memoryMap);
+    }
+    catch (std::runtime_error&)
+    {
+        // It may be missing for a moment while it is replaced, the watcher
+        // will see it come back
+        return Change::None;
+    }
+    std::string_view data = getCompleteLines(file->getView());
+
+    // If what was already read has changed, e.g. a category was added to the
+    // header, then the whole file has to be read again. The same goes for if
+    // there wasn't a header to read before
+    bool rewritten =
+        parsedHeader.empty() || data.size() < parsedSize ||
+        data.substr(0, parsedHeader.size()) != parsedHeader ||
+        data.substr(parsedSize - parsedTail.size(), parsedTail.size()) !=
+            parsedTail;
+    if (!rewritten && data.size() == parsedSize)
+        return Change::None;
+
+    // Rows added to a long format file can change any of the rows, so it's
+    // read again too
+    if (rewritten || options.tableFormat == TableFormat::Long)
+    {
+        replacedDataset = std::move(dataset);
+        parse(data, CacheMode::Off);
+        return Change::Reloaded;
+    }
+
+    // Otherwise only the rows added to the end need reading
+    try
+    {
+        if (!format)
+        {
+            CsvScanner scanner(data, options.scanner);
+            format = options.numberFormat
+                         ? *options.numberFormat
+                         : detectFormat(scanner, data, parsedSize);
+        }
+        parseRows(data, parsedSize, options, *format, dataset);
+    }
+    catch (std::exception& e)
+    {
+        throw std::runtime_error(
+            "Failed to parse/understand CSV file, are you sure its valid!");
+    }
+    setParsedEnd(data);
+    return Change::RowsAdded;
+}
+
+std::string_view CsvParser::getCompleteLines(std::string_view data) const
+{
+    // When following the file, the last line may still be being written if
+    // it doesn't end in a newline, so it's left until it does
+    if (!options.follow)
+        return data;
+    std::size_t lastNewline = data.rfind('\n');
+    return data.substr(0, lastNewline == std::string_view::npos
+                              ? 0
+                              : lastNewline + 1);
+}
+
+void CsvParser::parse(std::string_view data, CacheMode cacheMode)
+{
+    // Skip parsing if the file was parsed before, with the same settings
+    std::optional<DatasetCache> cache;
+    if (cacheMode != CacheMode::Off)
+    {
+        cache.emplace(fileName, data, getCacheSettings(options));
+        if (cacheMode == CacheMode::On &&
+            cache->load(name, categories, dataset))
+        {
+            dataset.setLayout(options.layout);
+            if (options.follow)
             {
-                // If theres a quotation mark present, look for the closing
-                // quotation mark, not a comma, and then add 1 to get to the
-                // comma after it (or line.end())
-                std::string value;
-                if ((prevIt + 1) != line.end() && *(prevIt + 1) == '"')
+                // Just the header, to know where the rows start, and the
+                // number format, so that rows added later are read the same
+                // as they would be without the cache
+                try
                 {
-                    it = 1 + std::find(prevIt + 2, line.end(), '"');
-                    value = std::string(prevIt + 2, it - 1);
+                    std::string cachedName;
+                    std::vector<std::string> cachedCategories;
+                    CsvScanner scanner(data, options.scanner);
+                    std::size_t rowsStart = parseHeader(
+                        scanner, data, cachedName, cachedCategories);
+                    parsedHeader = std::string(data.substr(0, rowsStart));
+                    format.reset();
+                    if (rowsStart < data.size())
+                        format = options.numberFormat
+                                     ? *options.numberFormat
+                                     : detectFormat(
+                                           scanner, data, rowsStart,
+                                           options.tableFormat ==
+                                                   TableFormat::Long
+                                               ? 2
+                                               : 1);
                 }
-                else
+                catch (std::exception& e)
                 {
-                    it = std::find(prevIt + 1, line.end(), ',');
-                    value = std::string(prevIt + 1, it);
+                    throw std::runtime_error("Failed to parse/understand CSV "
+                                             "file, are you sure its valid!");
                 }
+                setParsedEnd(data);
+            }
+            return;
+        }
+    }
 
-                if (!value.empty())
-                {
-                    is.clear();
-                    is.str(value);
-                    long double ld;
-                    is >> ld;
-                    r.values.push_back(ld);
-                }
-                else
-                {
-                    if (r.values.empty())
-                        // If the value is blank, i.e. 2 adjacent commas, enter
-                        // 0
-                        r.values.push_back(0);
-                    else
-                        r.values.push_back(r.values.back());
-                }
+    try
+    {
+        // Read in the categories row, and then every row after it
+        name.clear();
+        categories.clear();
+        format.reset();
+        CsvScanner scanner(data, options.scanner);
+        dataset = Dataset(options.layout);
+        std::size_t rowsStart;
+        if (options.tableFormat == TableFormat::Long)
+        {
+            // Read in a row at a time, pivoting them into the dataset
+            rowsStart = parseLongHeader(scanner, data, name);
+            if (rowsStart < data.size())
+                format = options.numberFormat
+                             ? *options.numberFormat
+                             : detectFormat(scanner, data, rowsStart, 2);
 
-                prevIt = it;
+            LongFormatPivot pivot;
+            parseLongRows(scanner, data, rowsStart,
+                          format ? *format : NumberFormat(), pivot);
+            pivot.finish(options.categoryOrder, categories, dataset);
+        }
+        else
+        {
+            rowsStart = parseHeader(scanner, data, name, categories);
+            dataset.setCategoryCount(categories.size());
+            if (rowsStart < data.size())
+            {
+                format = options.numberFormat
+                             ? *options.numberFormat
+                             : detectFormat(scanner, data, rowsStart);
+                parseRows(data, rowsStart, options, *format, dataset);
             }
-            rows.push_back(std::move(r));
         }
+        parsedHeader = std::string(data.substr(0, rowsStart));
     }
     catch (std::exception& e)
     {
         throw std::runtime_error(
             "Failed to parse/understand CSV file, are you sure its valid!");
     }
+    setParsedEnd(data);
+
+    // Not being able to write the cache only means the next load is slower
+    if (cache)
+        cache->save(name, categories, dataset);
+}
+
+void CsvParser::setParsedEnd(std::string_view data)
+{
+    parsedSize = data.size();
+    std::size_t tailSize = std::min(
+        TailCheckSize, parsedSize - std::min(parsedSize, parsedHeader.size()));
+    parsedTail = std::string(data.substr(parsedSize - tailSize, tailSize));
 }
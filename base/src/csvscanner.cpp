@@ -0,0 +1,199 @@
+#include "viszbase/csvscanner.hpp"
+
+#include <cstring>
+
+#include "viszbase/simd.hpp"
+
+namespace
+{
+constexpr std::size_t BlockSize = 64;
+
+int countTrailingZeros(std::uint64_t mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return index;
+#else
+    return __builtin_ctzll(mask);
+#endif
+}
+
+CsvBlockMasks scanBlockScalar(const char* block)
+{
+    CsvBlockMasks masks{0, 0, 0};
+    for (std::size_t i = 0; i < BlockSize; i++)
+    {
+        std::uint64_t bit = std::uint64_t(1) << i;
+        switch (block[i])
+        {
+        case ',':
+            masks.commas |= bit;
+            break;
+        case '"':
+            masks.quotes |= bit;
+            break;
+        case '\n':
+            masks.newlines |= bit;
+            break;
+        }
+    }
+    return masks;
+}
+
+#ifdef VISZBASE_SSE2
+CsvBlockMasks scanBlockSSE2(const char* block)
+{
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i newline = _mm_set1_epi8('\n');
+
+    CsvBlockMasks masks{0, 0, 0};
+    for (std::size_t i = 0; i < BlockSize; i += 16)
+    {
+        __m128i bytes =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+        // movemask gives one bit per byte, for the 16 bytes just compared
+        masks.commas |= std::uint64_t(_mm_movemask_epi8(
+                            _mm_cmpeq_epi8(bytes, comma)))
+                        << i;
+        masks.quotes |= std::uint64_t(_mm_movemask_epi8(
+                            _mm_cmpeq_epi8(bytes, quote)))
+                        << i;
+        masks.newlines |= std::uint64_t(_mm_movemask_epi8(
+                              _mm_cmpeq_epi8(bytes, newline)))
+                          << i;
+    }
+    return masks;
+}
+#endif
+
+#ifdef VISZBASE_AVX2
+TARGET_AVX2 CsvBlockMasks scanBlockAVX2(const char* block)
+{
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i newline = _mm256_set1_epi8('\n');
+
+    CsvBlockMasks masks{0, 0, 0};
+    for (std::size_t i = 0; i < BlockSize; i += 32)
+    {
+        __m256i bytes =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i));
+        // movemask gives one bit per byte, for the 32 bytes just compared
+        masks.commas |= std::uint64_t(std::uint32_t(_mm256_movemask_epi8(
+                            _mm256_cmpeq_epi8(bytes, comma))))
+                        << i;
+        masks.quotes |= std::uint64_t(std::uint32_t(_mm256_movemask_epi8(
+                            _mm256_cmpeq_epi8(bytes, quote))))
+                        << i;
+        masks.newlines |= std::uint64_t(std::uint32_t(_mm256_movemask_epi8(
+                              _mm256_cmpeq_epi8(bytes, newline))))
+                          << i;
+    }
+    return masks;
+}
+#endif
+} // namespace
+
+bool CsvScanner::isSupported(CsvScannerKind kind)
+{
+    switch (kind)
+    {
+    case CsvScannerKind::Auto:
+    case CsvScannerKind::Scalar:
+        return true;
+    case CsvScannerKind::SSE2:
+#ifdef VISZBASE_SSE2
+        return true;
+#else
+        return false;
+#endif
+    case CsvScannerKind::AVX2:
+        return cpuHasAVX2();
+    }
+    return false;
+}
+
+CsvScannerKind CsvScanner::getBestKind()
+{
+    if (isSupported(CsvScannerKind::AVX2))
+        return CsvScannerKind::AVX2;
+    if (isSupported(CsvScannerKind::SSE2))
+        return CsvScannerKind::SSE2;
+    return CsvScannerKind::Scalar;
+}
+
+CsvScanner::CsvScanner(std::string_view data, CsvScannerKind requestedKind)
+    : data{data}, kind{requestedKind}, blockStart{std::string_view::npos}
+{
+    // Fall back to the best available if the CPU can't run the one asked for
+    if (kind == CsvScannerKind::Auto || !isSupported(kind))
+        kind = getBestKind();
+
+    switch (kind)
+    {
+#ifdef VISZBASE_AVX2
+    case CsvScannerKind::AVX2:
+        scanBlock = scanBlockAVX2;
+        break;
+#endif
+#ifdef VISZBASE_SSE2
+    case CsvScannerKind::SSE2:
+        scanBlock = scanBlockSSE2;
+        break;
+#endif
+    default:
+        scanBlock = scanBlockScalar;
+    }
+}
+
+void CsvScanner::loadBlock(std::size_t start)
+{
+    blockStart = start;
+    if (start + BlockSize <= data.size())
+    {
+        masks = scanBlock(data.data() + start);
+        return;
+    }
+
+    // The last block is cut short, so scan a padded copy of it instead of
+    // reading past the end of the data
+    char padded[BlockSize] = {};
+    std::memcpy(padded, data.data() + start, data.size() - start);
+    masks = scanBlock(padded);
+}
+
+template <std::uint64_t CsvBlockMasks::*... Masks>
+std::size_t CsvScanner::find(std::size_t pos)
+{
+    while (pos < data.size())
+    {
+        std::size_t start = pos - (pos % BlockSize);
+        if (start != blockStart)
+            loadBlock(start);
+
+        // Drop the bits for the characters before 'pos'
+        std::uint64_t mask = ((masks.*Masks) | ...) >> (pos - start);
+        if (mask != 0)
+            return pos + countTrailingZeros(mask);
+
+        pos = start + BlockSize;
+    }
+    return data.size();
+}
+
+std::size_t CsvScanner::findSeparator(std::size_t pos)
+{
+    return find<&CsvBlockMasks::commas, &CsvBlockMasks::newlines>(pos);
+}
+
+std::size_t CsvScanner::findQuote(std::size_t pos)
+{
+    return find<&CsvBlockMasks::quotes>(pos);
+}
+
+std::size_t CsvScanner::findNewline(std::size_t pos)
+{
+    return find<&CsvBlockMasks::newlines>(pos);
+}
@@ -0,0 +1,246 @@
+#include "viszbase/datasetcache.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+#include "viszbase/hash.hpp"
+#include "viszbase/mappedfile.hpp"
+#include "viszbase/tempfile.hpp"
+
+namespace
+{
+constexpr char Magic[8] = {'N', 'V', 'Z', 'C', 'A', 'C', 'H', 'E'};
+// Changed whenever the layout of the file changes
+constexpr std::uint32_t Version = 1;
+// The file is written in the machine's byte order, this reads differently
+// on a machine with the other order
+constexpr std::uint32_t ByteOrderMark = 0x01020304;
+// The values start on a multiple of this, so they're aligned once mapped
+constexpr std::uint64_t ValuesAlignment = 64;
+
+struct Header
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    // Cache files are only used with the same type of Value
+    std::uint32_t valueSize;
+    std::uint32_t valueDigits;
+    std::uint32_t layout;
+    std::uint32_t reserved;
+    DatasetCacheKey key;
+    std::uint64_t categoryCount;
+    std::uint64_t rowCount;
+    std::uint64_t valuesOffset;
+};
+
+std::uint64_t getStringSize(std::string_view str)
+{
+    return sizeof(std::uint32_t) + str.size();
+}
+
+void writeString(std::ostream& out, std::string_view str)
+{
+    std::uint32_t length = str.size();
+    out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    out.write(str.data(), length);
+}
+
+// Reads a string written by writeString and moves 'pos' past it, returns
+// false if it would go past 'end'. The string is left where it is
+bool readString(const char*& pos, const char* end, std::string_view& str)
+{
+    std::uint32_t length;
+    if (std::size_t(end - pos) < sizeof(length))
+        return false;
+    std::memcpy(&length, pos, sizeof(length));
+    pos += sizeof(length);
+
+    if (std::size_t(end - pos) < length)
+        return false;
+    str = std::string_view(pos, length);
+    pos += length;
+    return true;
+}
+
+bool readStrings(const char*& pos, const char* end, std::uint64_t count,
+                 std::vector<std::string_view>& strings)
+{
+    // Every string takes at least its length, so don't trust a count that
+    // can't fit in what's left
+    if (count > std::uint64_t(end - pos) / sizeof(std::uint32_t))
+        return false;
+
+    strings.resize(count);
+    for (auto& str : strings)
+        if (!readString(pos, end, str))
+            return false;
+    return true;
+}
+} // namespace
+
+bool DatasetCacheKey::operator==(const DatasetCacheKey& other) const
+{
+    return fileSize == other.fileSize && modifiedTime == other.modifiedTime &&
+           contentHash == other.contentHash &&
+           settingsHash == other.settingsHash;
+}
+
+DatasetCache::DatasetCache(const std::string& csvFileName,
+                           std::string_view contents,
+                           std::string_view settings)
+    : path{csvFileName + ".nvzcache"}, key{}
+{
+    std::error_code sizeError, timeError;
+    key.fileSize = std::filesystem::file_size(csvFileName, sizeError);
+    key.modifiedTime = std::filesystem::last_write_time(csvFileName, timeError)
+                           .time_since_epoch()
+                           .count();
+    key.contentHash = hashContents(contents);
+    key.settingsHash = hashBytes(HashStart, settings.data(), settings.size());
+
+    valid = !sizeError && !timeError && key.fileSize == contents.size();
+}
+
+bool DatasetCache::load(std::string& name, std::vector<std::string>& categories,
+                        Dataset& dataset) const
+{
+    if (!valid)
+        return false;
+
+    std::shared_ptr<MappedFile> file;
+    try
+    {
+        file = std::make_shared<MappedFile>(path);
+    }
+    catch (std::runtime_error&)
+    {
+        return false;
+    }
+
+    const char* data = file->getData();
+    std::size_t size = file->getSize();
+    Header header;
+    if (size < sizeof(header))
+        return false;
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 ||
+        header.version != Version || header.byteOrder != ByteOrderMark ||
+        header.valueSize != sizeof(Value) ||
+        header.valueDigits != std::numeric_limits<Value>::digits ||
+        header.layout > std::uint32_t(DatasetLayout::CategoryMajor) ||
+        !(header.key == key) || header.valuesOffset > size)
+        return false;
+
+    // Check the values fit before reading any of them
+    std::uint64_t valueCount = header.rowCount * header.categoryCount;
+    if (header.categoryCount != 0 &&
+        valueCount / header.categoryCount != header.rowCount)
+        return false;
+    if ((size - header.valuesOffset) / sizeof(Value) < valueCount ||
+        header.valuesOffset % alignof(Value) != 0)
+        return false;
+
+    const char* pos = data + sizeof(header);
+    const char* stringsEnd = data + header.valuesOffset;
+    std::string_view cachedName;
+    std::vector<std::string_view> cachedCategories, names;
+    if (!readString(pos, stringsEnd, cachedName) ||
+        !readStrings(pos, stringsEnd, header.categoryCount,
+                     cachedCategories) ||
+        !readStrings(pos, stringsEnd, header.rowCount, names))
+        return false;
+
+    name = std::string(cachedName);
+    categories.assign(cachedCategories.begin(), cachedCategories.end());
+    dataset = Dataset(DatasetLayout(header.layout));
+    dataset.setCategoryCount(categories.size());
+    // The values are used straight from the mapped file, so only the parts
+    // of it that are looked at are ever read from disk
+    dataset.setRows(
+        names, file,
+        reinterpret_cast<const Value*>(data + header.valuesOffset));
+    return true;
+}
+
+bool DatasetCache::save(const std::string& name,
+                        const std::vector<std::string>& categories,
+                        const Dataset& dataset) const
+{
+    if (!valid)
+        return false;
+
+    Header header{};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.byteOrder = ByteOrderMark;
+    header.valueSize = sizeof(Value);
+    header.valueDigits = std::numeric_limits<Value>::digits;
+    header.layout = std::uint32_t(dataset.getLayout());
+    header.key = key;
+    header.categoryCount = dataset.getCategoryCount();
+    header.rowCount = dataset.getRowCount();
+
+    std::uint64_t stringsEnd = sizeof(header) + getStringSize(name);
+    for (const auto& category : categories)
+        stringsEnd += getStringSize(category);
+    for (const auto& rowName : dataset.getNames())
+        stringsEnd += getStringSize(rowName);
+    header.valuesOffset =
+        (stringsEnd + ValuesAlignment - 1) / ValuesAlignment * ValuesAlignment;
+
+    // Write to a temporary file and then move it into place, so a cache
+    // file is either complete or not there at all, even with another
+    // process saving it too
+    std::string tempPath = getTempPath(path);
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open())
+            return false;
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        writeString(out, name);
+        for (const auto& category : categories)
+            writeString(out, category);
+        for (const auto& rowName : dataset.getNames())
+            writeString(out, rowName);
+
+        const char padding[ValuesAlignment] = {};
+        out.write(padding, header.valuesOffset - stringsEnd);
+
+        // Leave out any space the dataset has reserved for more rows
+        auto writeValues = [&](const Value* values, std::size_t count)
+        {
+            out.write(reinterpret_cast<const char*>(values),
+                      count * sizeof(Value));
+        };
+        if (dataset.getLayout() == DatasetLayout::RowMajor)
+            writeValues(dataset.getRow(0),
+                        dataset.getRowCount() * dataset.getCategoryCount());
+        else
+            for (std::size_t c = 0; c < dataset.getCategoryCount(); c++)
+                writeValues(dataset.getCategory(c), dataset.getRowCount());
+
+        if (!out.good())
+        {
+            out.close();
+            std::error_code error;
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error)
+    {
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,104 @@
+#include "viszbase/distancefield.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+constexpr double Infinity = 1e20;
+
+// The squared distance transform of a line of 'length' values, 'stride'
+// apart, in place (Felzenszwalb and Huttenlocher). Each value becomes the
+// least of every other value plus its squared distance away. 'f', 'v' and
+// 'z' are work space, the length of the line and one more for 'z'
+void transformLine(double* grid, int stride, int length, double* f, int* v,
+                   double* z)
+{
+    // Find the lower envelope of the parabolas rooted at each value
+    v[0] = 0;
+    z[0] = -Infinity;
+    z[1] = Infinity;
+    f[0] = grid[0];
+    for (int q = 1, k = 0; q < length; q++)
+    {
+        f[q] = grid[q * stride];
+        double s;
+        do
+        {
+            int r = v[k];
+            s = (f[q] - f[r] + double(q) * q - double(r) * r) / (q - r) / 2;
+        } while (s <= z[k] && --k > -1);
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = Infinity;
+    }
+
+    // Then read the envelope off at each point
+    for (int q = 0, k = 0; q < length; q++)
+    {
+        while (z[k + 1] < q)
+            k++;
+        int r = v[k];
+        grid[q * stride] = f[r] + double(q - r) * (q - r);
+    }
+}
+
+// Columns then rows, as the squared distance splits into the two
+void transform(std::vector<double>& grid, int width, int height)
+{
+    int longest = std::max(width, height);
+    std::vector<double> f(longest), z(longest + 1);
+    std::vector<int> v(longest);
+    for (int x = 0; x < width; x++)
+        transformLine(grid.data() + x, width, height, f.data(), v.data(),
+                      z.data());
+    for (int y = 0; y < height; y++)
+        transformLine(grid.data() + y * width, 1, width, f.data(), v.data(),
+                      z.data());
+}
+} // namespace
+
+void makeDistanceField(const unsigned char* bitmap, int width, int height,
+                       int pitch, int spread,
+                       std::vector<unsigned char>& field)
+{
+    int fieldWidth = width + 2 * spread;
+    int fieldHeight = height + 2 * spread;
+    std::size_t size = std::size_t(fieldWidth) * fieldHeight;
+
+    // The squared distance to the shape from outside it, and to the outside
+    // from inside the shape
+    std::vector<double> outer(size, Infinity);
+    std::vector<double> inner(size, 0);
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            double coverage = bitmap[y * pitch + x] / 255.0;
+            std::size_t i = std::size_t(y + spread) * fieldWidth + x + spread;
+            if (coverage == 1)
+            {
+                outer[i] = 0;
+                inner[i] = Infinity;
+            }
+            else if (coverage > 0)
+            {
+                // Half covered puts the edge through the middle
+                double distance = 0.5 - coverage;
+                outer[i] = distance > 0 ? distance * distance : 0;
+                inner[i] = distance < 0 ? distance * distance : 0;
+            }
+        }
+    }
+    transform(outer, fieldWidth, fieldHeight);
+    transform(inner, fieldWidth, fieldHeight);
+
+    field.resize(size);
+    for (std::size_t i = 0; i < size; i++)
+    {
+        double distance = std::sqrt(outer[i]) - std::sqrt(inner[i]);
+        double value = 127.5 - distance * 127.5 / spread;
+        field[i] = std::lround(std::clamp(value, 0.0, 255.0));
+    }
+}
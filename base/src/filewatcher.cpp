@@ -0,0 +1,78 @@
+#include "viszbase/filewatcher.hpp"
+
+#include <stdexcept>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+FileWatcher::FileWatcher(const std::string& fileName)
+    : path{std::filesystem::absolute(fileName)}
+{
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd == -1)
+        throw std::runtime_error("Failed to watch file: " + fileName);
+
+    // Watch the directory rather than the file, so the file being replaced
+    // (e.g. written elsewhere then moved over it) is noticed too
+    std::string directory = path.parent_path().string();
+    if (inotify_add_watch(inotifyFd, directory.c_str(),
+                          IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_TO |
+                              IN_CREATE) == -1)
+    {
+        close(inotifyFd);
+        throw std::runtime_error("Failed to watch file: " + fileName);
+    }
+}
+
+FileWatcher::~FileWatcher() { close(inotifyFd); }
+
+bool FileWatcher::hasChanged()
+{
+    const std::string name = path.filename().string();
+
+    // Go through every event waiting, looking for any about this file
+    bool changed = false;
+    alignas(inotify_event) char buffer[4096];
+    ssize_t length;
+    while ((length = read(inotifyFd, buffer, sizeof(buffer))) > 0)
+    {
+        for (char* p = buffer; p < buffer + length;)
+        {
+            auto* event = reinterpret_cast<inotify_event*>(p);
+            // If events were lost, any of them could have been this file
+            if ((event->len > 0 && name == event->name) ||
+                (event->mask & IN_Q_OVERFLOW))
+                changed = true;
+            p += sizeof(inotify_event) + event->len;
+        }
+    }
+    return changed;
+}
+#else
+FileWatcher::FileWatcher(const std::string& fileName) : path{fileName}
+{
+    std::error_code error;
+    lastSize = std::filesystem::file_size(path, error);
+    lastTime = std::filesystem::last_write_time(path, error);
+}
+
+FileWatcher::~FileWatcher() {}
+
+bool FileWatcher::hasChanged()
+{
+    std::error_code sizeError, timeError;
+    std::uintmax_t size = std::filesystem::file_size(path, sizeError);
+    auto time = std::filesystem::last_write_time(path, timeError);
+    // The file may be missing for a moment while it's being replaced
+    if (sizeError || timeError)
+        return false;
+
+    bool changed = (size != lastSize || time != lastTime);
+    lastSize = size;
+    lastTime = time;
+    return changed;
+}
+#endif
@@ -0,0 +1,96 @@
+#include "viszbase/fontmanager.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+#include FT_SIZES_H
+
+#include "viszbase/mappedfile.hpp"
+
+struct FontFace
+{
+    // FreeType reads the face from the file's memory for as long as it's
+    // open, so the file has to outlive it
+    MappedFile file;
+    FT_Face face = nullptr;
+
+    FontFace(FT_Library library, const std::string& filePath)
+        : file(filePath)
+    {
+        if (FT_New_Memory_Face(library,
+                               reinterpret_cast<const FT_Byte*>(file.getData()),
+                               file.getSize(), 0, &face))
+        {
+            throw std::runtime_error("Could not load font file!");
+        }
+    }
+
+    ~FontFace() { FT_Done_Face(face); }
+};
+
+Font::~Font()
+{
+    if (size)
+        FT_Done_Size(size);
+}
+
+Font::Font(Font&& other) noexcept
+    : face{std::move(other.face)}, size{std::exchange(other.size, nullptr)}
+{
+}
+
+Font& Font::operator=(Font&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (size)
+            FT_Done_Size(size);
+        face = std::move(other.face);
+        size = std::exchange(other.size, nullptr);
+    }
+    return *this;
+}
+
+FT_Face Font::getFace() const
+{
+    FT_Activate_Size(size);
+    return face->face;
+}
+
+std::string_view Font::getFileData() const { return face->file.getView(); }
+
+FontManager& FontManager::getInstance()
+{
+    static FontManager instance;
+    return instance;
+}
+
+FontManager::FontManager()
+{
+    if (FT_Init_FreeType(&library))
+    {
+        throw std::runtime_error("Failed to initialize fonts!");
+    }
+}
+
+FontManager::~FontManager() { FT_Done_FreeType(library); }
+
+Font FontManager::open(const std::string& filePath, int size)
+{
+    std::shared_ptr<FontFace> face = faces[filePath].lock();
+    if (!face)
+    {
+        face = std::make_shared<FontFace>(library, filePath);
+        faces[filePath] = face;
+    }
+
+    Font font;
+    font.face = face;
+    if (FT_New_Size(face->face, &font.size))
+    {
+        throw std::runtime_error("Could not load font file!");
+    }
+    FT_Activate_Size(font.size);
+    FT_Set_Char_Size(face->face, 0, size * 64, 96, 96);
+    return font;
+}
@@ -1,23 +1,26 @@
 #include "viszbase/fontrenderer.hpp"
 
-#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <stdexcept>
-#include <sstream>
 
 #include "glad/gl.hpp"
+#include "viszbase/distancefield.hpp"
+#include "viszbase/numberwriter.hpp"
 
 FontRenderer::FontRenderer()
-    : fontShader(
+    : fontShader(ShaderRegistry::getInstance().get(
 #include "shaders/font.vs"
           ,
 #include "shaders/font.fs"
-      )
+          ))
 {
     // Check the shader compiled successfully
-    if (!fontShader.getErrorMsg().empty())
+    if (!fontShader->getErrorMsg().empty())
     {
         throw std::runtime_error("Font shader error: " +
-                                 fontShader.getErrorMsg());
+                                 fontShader->getErrorMsg());
     }
 
     // Setup OpenGL rectangle
@@ -41,69 +44,225 @@ FontRenderer::FontRenderer()
     glEnableVertexAttribArray(1);
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float),
                           (void*)(3 * sizeof(float)));
-}
 
-void FontRenderer::loadCharacter(char32_t c)
-{
-    FT_Load_Char(face, c, FT_LOAD_RENDER);
+    // The quads go in a buffer of their own, moving on once per character
+    // rather than once per vertex
+    glGenBuffers(1, &instanceVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
 
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(GlyphQuad),
+                          (void*)offsetof(GlyphQuad, x));
+    glVertexAttribDivisor(2, 1);
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(GlyphQuad),
+                          (void*)offsetof(GlyphQuad, textureX));
+    glVertexAttribDivisor(3, 1);
+
+    glBindVertexArray(0);
+}
+
+FontRenderer::~FontRenderer()
+{
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &instanceVBO);
+}
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, face->glyph->bitmap.width,
-                 face->glyph->bitmap.rows, 0, GL_RED, GL_UNSIGNED_BYTE,
-                 face->glyph->bitmap.buffer);
+const FontRenderer::Character& FontRenderer::getCharacter(GlyphSet& glyphs,
+                                                        char32_t c)
+{
+    // Check character is loaded in, if not, load it in
+    auto it = glyphs.characters.find(c);
+    if (it != glyphs.characters.end())
+    {
+        glyphs.hits++;
+        glyphs.atlas.touch(it->second.location.page);
+        return it->second;
+    }
+    glyphs.misses++;
+    glyphs.changed = true;
 
+    FT_Face face = glyphs.font.getFace();
+    if (glyphs.mode == GlyphMode::Sdf)
+    {
+        // Hinting fits the outline to the pixels at one size, which is no
+        // help once it's scaled
+        FT_Load_Char(face, c, FT_LOAD_RENDER | FT_LOAD_NO_HINTING);
+    }
+    else
+        FT_Load_Char(face, c, FT_LOAD_RENDER);
+
+    const FT_GlyphSlot glyph = face->glyph;
+    // Scaled glyphs keep the fractions of a pixel they advance by
+    float advanceX = (glyphs.mode == GlyphMode::Sdf)
+                         ? glyph->advance.x / 64.0f
+                         : (unsigned)(glyph->advance.x / 64);
     Character character{
-        textureID,
-        face->glyph->bitmap.width,
-        face->glyph->bitmap.rows,
-        (unsigned)(face->glyph->advance.x / 64),
-        face->glyph->bitmap_top,
-        face->glyph->bitmap_left,
-        (int)(face->glyph->metrics.horiBearingY / 64),
+        {},
+        glyph->bitmap.width,
+        glyph->bitmap.rows,
+        advanceX,
+        glyph->bitmap_top,
+        glyph->bitmap_left,
+        (int)(glyph->metrics.horiBearingY / 64),
     };
 
-    characterMap[c] = character;
+    const FT_Bitmap& bitmap = glyph->bitmap;
+    std::uint64_t evictions = glyphs.atlas.getEvictionCount();
+    if (glyphs.mode == GlyphMode::Sdf && bitmap.width > 0 && bitmap.rows > 0)
+    {
+        // The field is larger than the bitmap by the spread on every side
+        std::vector<unsigned char> field;
+        makeDistanceField(bitmap.buffer, bitmap.width, bitmap.rows,
+                          bitmap.pitch, SdfSpread, field);
+        character.width += 2 * SdfSpread;
+        character.height += 2 * SdfSpread;
+        character.bitmap_left -= SdfSpread;
+        character.bitmap_top += SdfSpread;
+        character.location = glyphs.atlas.add(
+            field.data(), character.width, character.height, character.width);
+    }
+    else
+        character.location = glyphs.atlas.add(bitmap.buffer, bitmap.width,
+                                              bitmap.rows, bitmap.pitch);
+
+    // If a page was emptied to make room, the characters that were on it
+    // have to be rendered again next time
+    if (glyphs.atlas.getEvictionCount() != evictions)
+    {
+        for (it = glyphs.characters.begin(); it != glyphs.characters.end();)
+        {
+            if (it->second.location.page == character.location.page)
+                it = glyphs.characters.erase(it);
+            else
+                ++it;
+        }
+    }
+    return glyphs.characters.emplace(c, character).first->second;
 }
 
-void FontRenderer::loadFont(const std::string& filePath, int size)
+std::shared_ptr<FontRenderer::GlyphSet>
+FontRenderer::openGlyphSet(const std::string& path, int size, GlyphMode mode)
 {
-    FT_Error error;
+    auto glyphs = std::make_shared<GlyphSet>();
+    glyphs->font = FontManager::getInstance().open(path, size);
+    glyphs->mode = mode;
+    glyphs->size = size;
 
-    error = FT_Init_FreeType(&library);
-    if (error)
+    // Get overall height of font
+    FT_Face face = glyphs->font.getFace();
+    glyphs->yMin = FT_MulFix(face->bbox.yMin, face->size->metrics.y_scale) / 64;
+    glyphs->yMax = FT_MulFix(face->bbox.yMax, face->size->metrics.y_scale) / 64;
+
+    // Load the characters rendered last time, as long as the font file and
+    // everything that changes how they're rendered is the same
+    std::string settings =
+        std::to_string(size) + " " + std::to_string(int(mode)) + " " +
+        std::to_string(SdfSpread) + " " + std::to_string(FREETYPE_MAJOR) +
+        "." + std::to_string(FREETYPE_MINOR) + "." +
+        std::to_string(FREETYPE_PATCH);
+    glyphs->cache.emplace(glyphs->font.getFileData(), settings);
+    std::vector<CachedGlyph> cached;
+    if (glyphs->cache->load(glyphs->atlas, cached))
     {
-        throw std::runtime_error("Failed to initialize fonts!");
+        for (const CachedGlyph& glyph : cached)
+        {
+            glyphs->characters.emplace(
+                glyph.codepoint,
+                Character{{glyph.page, glyph.x, glyph.y},
+                          glyph.width,
+                          glyph.height,
+                          glyph.advanceX,
+                          glyph.bitmapTop,
+                          glyph.bitmapLeft,
+                          glyph.bearingY});
+        }
     }
+    return glyphs;
+}
+
+FontRenderer::GlyphSet::~GlyphSet()
+{
+    if (!cache || !changed)
+        return;
 
-    error = FT_New_Face(library, filePath.c_str(), 0, &face);
-    if (error)
+    std::vector<CachedGlyph> cached;
+    cached.reserve(characters.size());
+    for (const auto& [codepoint, ch] : characters)
     {
-        throw std::runtime_error("Could not load font file!");
+        cached.push_back({codepoint, ch.location.page, ch.location.x,
+                          ch.location.y, ch.width, ch.height, ch.advanceX,
+                          ch.bitmap_top, ch.bitmap_left, ch.bearingY});
     }
+    cache->save(atlas, cached);
+}
 
-    FT_Set_Char_Size(face, 0, size * 64, 96, 96);
-
-    // Allow textures to have a size that isn't a multiple of 4
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+std::shared_ptr<FontRenderer::GlyphSet>
+FontRenderer::getSdfGlyphSet(const std::string& path)
+{
+    // Only kept while a renderer is using it, as the atlas has to be gone
+    // before the OpenGL context is
+    static std::unordered_map<std::string, std::weak_ptr<GlyphSet>> sets;
+    std::shared_ptr<GlyphSet> glyphs = sets[path].lock();
+    if (!glyphs)
+    {
+        glyphs = openGlyphSet(path, SdfSize, GlyphMode::Sdf);
+        sets[path] = glyphs;
+    }
+    return glyphs;
+}
 
-    // Get overall height of font
-    yMin = FT_MulFix(face->bbox.yMin, face->size->metrics.y_scale) / 64;
-    yMax = FT_MulFix(face->bbox.yMax, face->size->metrics.y_scale) / 64;
-    fontHeight = (yMax - yMin);
+GlyphMode glyphModeFromArguments(const Arguments& args)
+{
+    std::string mode = args.get("-fontmode", "bitmap");
+    if (mode == "bitmap")
+        return GlyphMode::Bitmap;
+    if (mode == "sdf")
+        return GlyphMode::Sdf;
+    throw std::runtime_error("Font mode must be bitmap or sdf");
+}
 
-    // Load common characters
-    for (unsigned char character = 0; character < 255; character++)
+void FontRenderer::loadFont(const std::string& filePath, int size,
+                            GlyphMode mode)
+{
+    this->filePath = filePath;
+    if (mode == GlyphMode::Sdf)
     {
-        loadCharacter(character);
+        glyphs = getSdfGlyphSet(filePath);
+        if (!sdfShader)
+        {
+            sdfShader = ShaderRegistry::getInstance().get(
+#include "shaders/font.vs"
+                ,
+#include "shaders/fontsdf.fs"
+            );
+            if (!sdfShader->getErrorMsg().empty())
+            {
+                throw std::runtime_error("Font shader error: " +
+                                         sdfShader->getErrorMsg());
+            }
+        }
     }
+    else
+        glyphs = openGlyphSet(filePath, size, mode);
+    setSize(size);
+}
+
+void FontRenderer::setSize(float size)
+{
+    if (glyphs->mode == GlyphMode::Sdf)
+        scale = size / glyphs->size;
+    else if (int(size) != glyphs->size)
+        glyphs = openGlyphSet(filePath, size, GlyphMode::Bitmap);
+
+    yMax = glyphs->yMax * scale;
+    yMin = glyphs->yMin * scale;
+    fontHeight = (yMax - yMin);
+    // Runs already laid out are the old size
+    textRuns.clear();
+    evictionsSeen = glyphs->atlas.getEvictionCount();
 }
 
 // UTF helper functions
@@ -144,11 +303,73 @@ static char32_t utf8ToUtf32(const char* c)
     return result;
 }
 
-void FontRenderer::drawMsg(float x, float y, const std::string& msg,
+void FontRenderer::drawMsg(float x, float y, std::string_view msg,
                            math::Matrix<4, 4> projection)
 {
-    glUseProgram(fontShader.getProgram());
+    queueMsg(x, y, msg);
+    flush(projection);
+}
+
+void FontRenderer::queueMsg(float x, float y, std::string_view msg)
+{
+    queueRun(x, y, getTextRun(msg));
+}
+
+void FontRenderer::queueRun(float x, float y, const TextRun& run)
+{
+    for (std::size_t p = 0; p < run.pages.size(); p++)
+    {
+        glyphs->atlas.touch(run.pages[p]);
+        if (run.pages[p] >= pageQuads.size())
+            pageQuads.resize(run.pages[p] + 1);
+        std::vector<GlyphQuad>& quads = pageQuads[run.pages[p]];
+        std::size_t first = quads.size();
+        quads.insert(quads.end(), run.pageQuads[p].begin(),
+                     run.pageQuads[p].end());
+        for (std::size_t q = first; q < quads.size(); q++)
+        {
+            quads[q].x += x;
+            quads[q].y += y;
+        }
+    }
+}
 
+const FontRenderer::TextRun& FontRenderer::getTextRun(std::string_view msg)
+{
+    dropEvictedRuns();
+    auto it = textRuns.find(msg);
+    if (it == textRuns.end())
+    {
+        if (textRuns.size() >= MaxTextRuns)
+            evictTextRuns();
+
+        auto run = std::make_unique<TextRun>();
+        run->text = msg;
+        layOut(run->text, *run);
+        // Laying it out may have emptied a page, which this run's glyphs
+        // are now on
+        dropEvictedRuns();
+        it = textRuns.emplace(run->text, std::move(run)).first;
+    }
+    else
+    {
+        // Keep its pages from being emptied before it's drawn
+        for (unsigned page : it->second->pages)
+            glyphs->atlas.touch(page);
+    }
+    it->second->lastUsed = frame;
+    return *it->second;
+}
+
+void FontRenderer::layOut(std::string_view msg, TextRun& run)
+{
+    // Only empty the run's vectors, so laying out into the same run again
+    // reuses their memory
+    run.pages.clear();
+    for (std::vector<GlyphQuad>& quads : run.pageQuads)
+        quads.clear();
+
+    float x = 0;
     for (int i = 0; i < msg.length();)
     {
         char cStart = msg[i];
@@ -163,96 +384,145 @@ void FontRenderer::drawMsg(float x, float y, const std::string& msg,
         {
             c = cStart;
         }
+        const Character& ch = getCharacter(*glyphs, c);
 
-        // Check character is loaded in, if not, load it in
-        auto it = characterMap.find(c);
-        if (it == characterMap.end())
+        // Characters with nothing to draw, like spaces, only move along
+        if (ch.width > 0 && ch.height > 0)
         {
-            loadCharacter(c);
+            // Almost always all on the one page
+            auto page = std::find(run.pages.begin(), run.pages.end(),
+                                  ch.location.page);
+            if (page == run.pages.end())
+            {
+                run.pages.push_back(ch.location.page);
+                if (run.pageQuads.size() < run.pages.size())
+                    run.pageQuads.emplace_back();
+                page = run.pages.end() - 1;
+            }
+
+            run.pageQuads[page - run.pages.begin()].push_back(
+                {x + ch.bitmap_left * scale, yMax - ch.bitmap_top * scale,
+                 ch.width * scale, ch.height * scale, float(ch.location.x),
+                 float(ch.location.y), float(ch.width), float(ch.height)});
         }
-        Character& ch = characterMap[c];
-
-        // Setup matrices
-        math::setTranslate(translate, x + ch.bitmap_left,
-                           y + (yMax - ch.bitmap_top), 0.0f);
-        math::setScale(scale, ch.width, ch.height, 1.0f);
-        result = projection * translate * scale;
-        // Send data to shader
-        glUniformMatrix4fv(fontShader.getUniformLocation("matrix"), 1, GL_TRUE,
-                           *result);
-
-        // Draw the character
-        glBindTexture(GL_TEXTURE_2D, ch.textureID);
-        glBindVertexArray(VAO);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-        glBindVertexArray(0);
 
         // Advance the x position and move onto the next character
-        x += ch.advanceX;
+        x += ch.advanceX * scale;
         i += utf8_charLength(&cStart);
     }
+    run.width = std::lround(x);
 }
 
-static std::string convertLongDoubleToStr(const long double& num,
-                                          int decimalPoints)
+void FontRenderer::evictTextRuns()
 {
-    static std::ostringstream os;
-    // Clear the currently stored string (if any)
-    os.str("");
-    // Format the number to the system's locale
-    os.imbue(std::locale(""));
-    os << std::fixed;
-    os << std::setprecision(decimalPoints);
-    os << num;
+    // Runs used since the last flush may still be held by the caller
+    for (auto it = textRuns.begin(); it != textRuns.end();)
+    {
+        if (it->second->lastUsed < frame)
+            it = textRuns.erase(it);
+        else
+            ++it;
+    }
+}
+
+void FontRenderer::dropEvictedRuns()
+{
+    std::uint64_t evictions = glyphs->atlas.getEvictionCount();
+    if (evictions == evictionsSeen)
+        return;
+
+    // Runs used in this frame or the last kept their pages from being
+    // emptied, so none of those are let go of
+    for (auto it = textRuns.begin(); it != textRuns.end();)
+    {
+        const std::vector<unsigned>& pages = it->second->pages;
+        if (std::any_of(pages.begin(), pages.end(),
+                        [&](unsigned page)
+                        {
+                            return glyphs->atlas.wasEvictedSince(
+                                page, evictionsSeen);
+                        }))
+            it = textRuns.erase(it);
+        else
+            ++it;
+    }
+    evictionsSeen = evictions;
+}
+
+void FontRenderer::flush(const math::Matrix<4, 4>& projection)
+{
+    Shader& shader = (glyphs && glyphs->mode == GlyphMode::Sdf) ? *sdfShader
+                                                                 : *fontShader;
+    glUseProgram(shader.getProgram());
+    glUniformMatrix4fv(shader.getUniformLocation("matrix"), 1, GL_TRUE,
+                       *projection);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
 
-    return os.str();
+    // One draw for each page with characters on it
+    for (std::size_t page = 0; page < pageQuads.size(); page++)
+    {
+        std::vector<GlyphQuad>& quads = pageQuads[page];
+        if (quads.empty())
+            continue;
+
+        // Give the buffer new storage each time, rather than wait for the
+        // GPU to finish drawing from the old one
+        if (quads.size() > instanceCapacity)
+            instanceCapacity = std::max(quads.size(), instanceCapacity * 2);
+        glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(GlyphQuad),
+                     nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, quads.size() * sizeof(GlyphQuad),
+                        quads.data());
+
+        glBindTexture(GL_TEXTURE_2D, glyphs->atlas.getTexture(page));
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 6, quads.size());
+        quads.clear();
+    }
+
+    glBindVertexArray(0);
+    frame++;
+}
+
+void FontRenderer::endFrame() { GlyphAtlas::endFrame(); }
+
+FontRenderer::GlyphStats FontRenderer::getGlyphStats() const
+{
+    return {glyphs->hits, glyphs->misses, glyphs->atlas.getEvictionCount(),
+            glyphs->atlas.getPageCount(), glyphs->atlas.getMemoryUsage()};
 }
 
 void FontRenderer::drawLongDouble(float x, float y, const long double& num,
                                   int decimalPoints,
                                   math::Matrix<4, 4> projection)
 {
-    // Draw the formatted number
-    drawMsg(x, y, convertLongDoubleToStr(num, decimalPoints), projection);
+    queueLongDouble(x, y, num, decimalPoints);
+    flush(projection);
 }
 
-int FontRenderer::getWidthOfMsg(const std::string& msg)
+void FontRenderer::queueLongDouble(float x, float y, const long double& num,
+                                   int decimalPoints)
 {
-    int width = 0;
-    for (int i = 0; i < msg.length();)
-    {
-        char cStart = msg[i];
-        char32_t c;
-        // Check UTF8 byte length of the character
-        if (utf8_charLength(&msg[i]) > 1)
-        {
-            // Longer than 1 byte, convert to UTF32 before sending Freetype
-            c = utf8ToUtf32(&msg[i]);
-        }
-        else
-        {
-            c = cStart;
-        }
-
-        // Check character is loaded in, if not, load it in
-        auto it = characterMap.find(c);
-        if (it == characterMap.end())
-        {
-            loadCharacter(c);
-        }
-
-        Character& ch = characterMap[c];
-        // And width to total
-        width += ch.advanceX;
+    queueRun(x, y, getNumberRun(num, decimalPoints));
+}
 
-        i += utf8_charLength(&cStart);
-    }
+const FontRenderer::TextRun& FontRenderer::getNumberRun(const long double& num,
+                                                        int decimalPoints)
+{
+    // Format the number to the system's locale
+    NumberBuffer buffer;
+    layOut(writeNumber(num, decimalPoints, getSystemNumberFormat(), buffer),
+           numberRun);
+    return numberRun;
+}
 
-    return width;
+int FontRenderer::getWidthOfMsg(std::string_view msg)
+{
+    return getTextRun(msg).getWidth();
 }
 
 int FontRenderer::getWidthOfLongDouble(const long double& num,
                                        int decimalPoints)
 {
-    return getWidthOfMsg(convertLongDoubleToStr(num, decimalPoints));
+    return getNumberRun(num, decimalPoints).getWidth();
 }
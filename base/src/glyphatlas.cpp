@@ -0,0 +1,179 @@
+#include "viszbase/glyphatlas.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "glad/gl.hpp"
+
+namespace
+{
+// The frame being drawn, the same for every atlas
+std::uint64_t frame = 0;
+} // namespace
+
+GlyphAtlas::GlyphAtlas(std::size_t maxPages) : maxPages{maxPages} {}
+
+GlyphAtlas::~GlyphAtlas()
+{
+    for (const Page& page : pages)
+        glDeleteTextures(1, &page.texture);
+}
+
+void GlyphAtlas::touch(unsigned page) { pages[page].lastUsed = frame; }
+
+void GlyphAtlas::endFrame() { frame++; }
+
+GlyphAtlas::Location GlyphAtlas::add(const unsigned char* bitmap, int width,
+                                     int height, int pitch)
+{
+    if (width + Padding > PageSize || height + Padding > PageSize)
+        throw std::runtime_error("Glyph too large for the glyph atlas!");
+
+    // Start a new shelf if it doesn't fit on this one, and move to another
+    // page if there's no room for a new shelf
+    if (shelfX + width + Padding > PageSize)
+    {
+        shelfX = Padding;
+        shelfY += shelfHeight;
+        shelfHeight = 0;
+    }
+    if (pages.empty() || shelfY + height + Padding > PageSize)
+        nextPage();
+    while (shelfY + height + Padding > pages[currentPage].height)
+        growCurrentPage();
+
+    Location location{currentPage, shelfX, shelfY};
+    shelfX += width + Padding;
+    shelfHeight = std::max(shelfHeight, height + Padding);
+    touch(currentPage);
+
+    if (width > 0 && height > 0)
+    {
+        glBindTexture(GL_TEXTURE_2D, pages[currentPage].texture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, pitch);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, location.x, location.y, width,
+                        height, GL_RED, GL_UNSIGNED_BYTE, bitmap);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    }
+    return location;
+}
+
+std::size_t GlyphAtlas::getMemoryUsage() const
+{
+    std::size_t size = 0;
+    for (const Page& page : pages)
+        size += std::size_t(PageSize) * page.height;
+    return size;
+}
+
+GlyphAtlas::Packing GlyphAtlas::getPacking() const
+{
+    return {shelfX, shelfY, shelfHeight, currentPage};
+}
+
+void GlyphAtlas::readPage(unsigned page,
+                          std::vector<unsigned char>& pixels) const
+{
+    pixels.resize(std::size_t(PageSize) * pages[page].height);
+    glBindTexture(GL_TEXTURE_2D, pages[page].texture);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glGetTexImage(GL_TEXTURE_2D, 0, GL_RED, GL_UNSIGNED_BYTE, pixels.data());
+}
+
+void GlyphAtlas::loadPages(const unsigned char* pixels,
+                           const std::uint32_t* heights, std::size_t pageCount,
+                           const Packing& packing)
+{
+    for (std::size_t page = 0; page < pageCount; page++)
+    {
+        createPage(pixels, heights[page]);
+        pixels += std::size_t(PageSize) * heights[page];
+    }
+    currentPage = packing.currentPage;
+    shelfX = packing.shelfX;
+    shelfY = packing.shelfY;
+    shelfHeight = packing.shelfHeight;
+}
+
+void GlyphAtlas::nextPage()
+{
+    if (maxPages > 0 && pages.size() >= maxPages)
+    {
+        auto oldest = std::min_element(pages.begin(), pages.end(),
+                                       [](const Page& a, const Page& b)
+                                       { return a.lastUsed < b.lastUsed; });
+        // If every page is in use, go over the limit rather than lose
+        // glyphs that are about to be drawn
+        if (oldest->lastUsed + 1 < frame)
+        {
+            evictPage(oldest - pages.begin());
+            return;
+        }
+    }
+    addPage();
+}
+
+void GlyphAtlas::addPage()
+{
+    // Start it empty, as the padding around glyphs has to be
+    std::vector<unsigned char> empty(PageSize * MinPageHeight, 0);
+    createPage(empty.data(), MinPageHeight);
+    currentPage = pages.size() - 1;
+    shelfX = Padding;
+    shelfY = Padding;
+    shelfHeight = 0;
+}
+
+void GlyphAtlas::createPage(const unsigned char* pixels, int height)
+{
+    unsigned texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, PageSize, height, 0, GL_RED,
+                 GL_UNSIGNED_BYTE, pixels);
+
+    pages.push_back({texture, height, frame, 0});
+}
+
+void GlyphAtlas::evictPage(unsigned page)
+{
+    // Give the texture new, empty storage at the smallest height, which also
+    // hands back the memory it had grown to
+    std::vector<unsigned char> empty(PageSize * MinPageHeight, 0);
+    glBindTexture(GL_TEXTURE_2D, pages[page].texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, PageSize, MinPageHeight, 0, GL_RED,
+                 GL_UNSIGNED_BYTE, empty.data());
+
+    evictions++;
+    pages[page] = {pages[page].texture, MinPageHeight, frame, evictions};
+    currentPage = page;
+    shelfX = Padding;
+    shelfY = Padding;
+    shelfHeight = 0;
+}
+
+void GlyphAtlas::growCurrentPage()
+{
+    // Read back what's on it, then give the texture twice the rows with the
+    // new ones empty. Rare enough that the round trip doesn't matter
+    Page& page = pages[currentPage];
+    int height = std::min(page.height * 2, PageSize);
+    std::vector<unsigned char> pixels(PageSize * height, 0);
+    glBindTexture(GL_TEXTURE_2D, page.texture);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glGetTexImage(GL_TEXTURE_2D, 0, GL_RED, GL_UNSIGNED_BYTE, pixels.data());
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, PageSize, height, 0, GL_RED,
+                 GL_UNSIGNED_BYTE, pixels.data());
+    page.height = height;
+}
@@ -0,0 +1,205 @@
+#include "viszbase/glyphcache.hpp"
+
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include "viszbase/cachedirectory.hpp"
+#include "viszbase/hash.hpp"
+#include "viszbase/mappedfile.hpp"
+#include "viszbase/tempfile.hpp"
+
+namespace
+{
+constexpr char Magic[8] = {'N', 'V', 'Z', 'G', 'L', 'Y', 'P', 'H'};
+// Changed whenever the layout of the file changes
+constexpr std::uint32_t Version = 2;
+// The file is written in the machine's byte order, this reads differently
+// on a machine with the other order
+constexpr std::uint32_t ByteOrderMark = 0x01020304;
+// The pixels start on a multiple of this
+constexpr std::uint64_t PixelsAlignment = 64;
+
+struct Header
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint32_t pageSize;
+    std::uint32_t reserved;
+    GlyphCacheKey key;
+    std::uint64_t glyphCount;
+    std::uint64_t pageCount;
+    GlyphAtlas::Packing packing;
+    std::uint64_t pixelsOffset;
+};
+
+// The header is followed by the height of each page, then the glyphs, then
+// the pixels of each page
+std::uint64_t getPixelsSize(const std::vector<std::uint32_t>& heights)
+{
+    std::uint64_t size = 0;
+    for (std::uint32_t height : heights)
+        size += std::uint64_t(GlyphAtlas::PageSize) * height;
+    return size;
+}
+} // namespace
+
+bool GlyphCacheKey::operator==(const GlyphCacheKey& other) const
+{
+    return fileSize == other.fileSize && contentHash == other.contentHash &&
+           settingsHash == other.settingsHash;
+}
+
+GlyphCache::GlyphCache(std::string_view fontContents,
+                       std::string_view settings)
+    : key{}
+{
+    key.fileSize = fontContents.size();
+    key.contentHash = hashContents(fontContents);
+    key.settingsHash = hashBytes(HashStart, settings.data(), settings.size());
+
+    // The name only has to tell fonts and settings apart, the key in the
+    // file is what's checked
+    char name[16];
+    std::uint64_t nameHash = key.contentHash ^ (key.settingsHash * 31);
+    auto result = std::to_chars(name, name + sizeof(name), nameHash, 16);
+    path = (getCacheDirectory() / std::string(name, result.ptr)).string() +
+           ".nvzglyphs";
+}
+
+bool GlyphCache::load(GlyphAtlas& atlas, std::vector<CachedGlyph>& glyphs) const
+{
+    std::unique_ptr<MappedFile> file;
+    try
+    {
+        file = std::make_unique<MappedFile>(path);
+    }
+    catch (std::runtime_error&)
+    {
+        return false;
+    }
+
+    const char* data = file->getData();
+    std::size_t size = file->getSize();
+    Header header;
+    if (size < sizeof(header))
+        return false;
+    std::memcpy(&header, data, sizeof(header));
+
+    const GlyphAtlas::Packing& packing = header.packing;
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 ||
+        header.version != Version || header.byteOrder != ByteOrderMark ||
+        header.pageSize != GlyphAtlas::PageSize || !(header.key == key) ||
+        header.pixelsOffset < sizeof(header) || header.pixelsOffset > size ||
+        header.pageCount == 0 ||
+        header.pageCount > (size - header.pixelsOffset) / GlyphAtlas::PageSize)
+        return false;
+
+    // Check everything fits before reading any of it
+    std::uint64_t heightsEnd =
+        sizeof(header) + header.pageCount * sizeof(std::uint32_t);
+    if (heightsEnd > header.pixelsOffset ||
+        header.glyphCount >
+            (header.pixelsOffset - heightsEnd) / sizeof(CachedGlyph))
+        return false;
+    std::vector<std::uint32_t> heights(header.pageCount);
+    std::memcpy(heights.data(), data + sizeof(header),
+                heightsEnd - sizeof(header));
+    for (std::uint32_t height : heights)
+        if (height < GlyphAtlas::MinPageHeight ||
+            height > GlyphAtlas::PageSize)
+            return false;
+    if (size - header.pixelsOffset < getPixelsSize(heights))
+        return false;
+
+    if (packing.currentPage >= header.pageCount || packing.shelfX < 0 ||
+        packing.shelfY < 0 ||
+        packing.shelfY > std::int32_t(heights[packing.currentPage]) ||
+        packing.shelfHeight < 0)
+        return false;
+
+    std::vector<CachedGlyph> cachedGlyphs(header.glyphCount);
+    std::memcpy(cachedGlyphs.data(), data + heightsEnd,
+                header.glyphCount * sizeof(CachedGlyph));
+    for (const CachedGlyph& glyph : cachedGlyphs)
+        if (glyph.page >= header.pageCount || glyph.x < 0 || glyph.y < 0 ||
+            std::uint64_t(glyph.x) + glyph.width > GlyphAtlas::PageSize ||
+            std::uint64_t(glyph.y) + glyph.height > heights[glyph.page])
+            return false;
+
+    atlas.loadPages(
+        reinterpret_cast<const unsigned char*>(data + header.pixelsOffset),
+        heights.data(), header.pageCount, packing);
+    glyphs = std::move(cachedGlyphs);
+    return true;
+}
+
+bool GlyphCache::save(const GlyphAtlas& atlas,
+                      const std::vector<CachedGlyph>& glyphs) const
+{
+    Header header{};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.byteOrder = ByteOrderMark;
+    header.pageSize = GlyphAtlas::PageSize;
+    header.key = key;
+    header.glyphCount = glyphs.size();
+    header.pageCount = atlas.getPageCount();
+    header.packing = atlas.getPacking();
+
+    std::vector<std::uint32_t> heights(atlas.getPageCount());
+    for (unsigned page = 0; page < heights.size(); page++)
+        heights[page] = atlas.getPageHeight(page);
+
+    std::uint64_t glyphsEnd = sizeof(header) +
+                              heights.size() * sizeof(std::uint32_t) +
+                              glyphs.size() * sizeof(CachedGlyph);
+    header.pixelsOffset = (glyphsEnd + PixelsAlignment - 1) /
+                          PixelsAlignment * PixelsAlignment;
+
+    // Write to a temporary file and then move it into place, so a cache
+    // file is either complete or not there at all, even with another
+    // process saving it too
+    std::string tempPath = getTempPath(path);
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open())
+            return false;
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(heights.data()),
+                  heights.size() * sizeof(std::uint32_t));
+        out.write(reinterpret_cast<const char*>(glyphs.data()),
+                  glyphs.size() * sizeof(CachedGlyph));
+        const char padding[PixelsAlignment] = {};
+        out.write(padding, header.pixelsOffset - glyphsEnd);
+
+        std::vector<unsigned char> pixels;
+        for (unsigned page = 0; page < atlas.getPageCount(); page++)
+        {
+            atlas.readPage(page, pixels);
+            out.write(reinterpret_cast<const char*>(pixels.data()),
+                      pixels.size());
+        }
+
+        if (!out.good())
+        {
+            out.close();
+            std::error_code error;
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error)
+    {
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,33 @@
+#include "viszbase/hash.hpp"
+
+namespace
+{
+// Files up to this size are hashed whole, larger ones have evenly spaced
+// samples hashed
+constexpr std::size_t FullHashLimit = 4 << 20;
+constexpr std::size_t SampleCount = 256;
+constexpr std::size_t SampleSize = 4096;
+} // namespace
+
+std::uint64_t hashBytes(std::uint64_t hash, const char* data, std::size_t size)
+{
+    for (std::size_t i = 0; i < size; i++)
+    {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
+std::uint64_t hashContents(std::string_view contents)
+{
+    if (contents.size() <= FullHashLimit)
+        return hashBytes(HashStart, contents.data(), contents.size());
+
+    // The first sample is at the start of the file and the last at the end
+    std::uint64_t hash = HashStart;
+    std::size_t spacing = (contents.size() - SampleSize) / (SampleCount - 1);
+    for (std::size_t i = 0; i < SampleCount; i++)
+        hash = hashBytes(hash, contents.data() + i * spacing, SampleSize);
+    return hash;
+}
@@ -0,0 +1,229 @@
+#include "viszbase/interpolation.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "viszbase/simd.hpp"
+
+namespace
+{
+// A NaN value is skipped, as comparisons with it are always false
+template <typename T> void include(ValueRange<T>& range, T value)
+{
+    range.lowest = std::min(range.lowest, value);
+    range.highest = std::max(range.highest, value);
+}
+
+template <typename T>
+ValueRange<T> interpolateScalar(const T* from, const T* to, T t, T* out,
+                                std::size_t count, ValueRange<T> range)
+{
+    for (std::size_t i = 0; i < count; i++)
+    {
+        out[i] = from[i] + t * (to[i] - from[i]);
+        include(range, out[i]);
+    }
+    return range;
+}
+
+template <typename T> ValueRange<T> emptyRange()
+{
+    return {std::numeric_limits<T>::infinity(),
+            -std::numeric_limits<T>::infinity()};
+}
+
+// Combines the lanes of the lowest and highest registers, once stored
+template <typename T, std::size_t Lanes>
+ValueRange<T> combineLanes(const T (&lowest)[Lanes], const T (&highest)[Lanes])
+{
+    ValueRange<T> range = emptyRange<T>();
+    for (std::size_t i = 0; i < Lanes; i++)
+    {
+        range.lowest = std::min(range.lowest, lowest[i]);
+        range.highest = std::max(range.highest, highest[i]);
+    }
+    return range;
+}
+
+// The SIMD versions do as many values as fill whole registers, and leave the
+// rest to the scalar version. The new value goes first in min and max, which
+// then skip a NaN one the same as the scalar version does
+
+#ifdef VISZBASE_SSE2
+ValueRange<float> interpolateSSE2(const float* from, const float* to, float t,
+                                  float* out, std::size_t count)
+{
+    __m128 factor = _mm_set1_ps(t);
+    __m128 lowest = _mm_set1_ps(std::numeric_limits<float>::infinity());
+    __m128 highest = _mm_set1_ps(-std::numeric_limits<float>::infinity());
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 a = _mm_loadu_ps(from + i);
+        __m128 b = _mm_loadu_ps(to + i);
+        __m128 value = _mm_add_ps(a, _mm_mul_ps(factor, _mm_sub_ps(b, a)));
+        _mm_storeu_ps(out + i, value);
+        lowest = _mm_min_ps(value, lowest);
+        highest = _mm_max_ps(value, highest);
+    }
+
+    float lowestLanes[4], highestLanes[4];
+    _mm_storeu_ps(lowestLanes, lowest);
+    _mm_storeu_ps(highestLanes, highest);
+    return interpolateScalar(from + i, to + i, t, out + i, count - i,
+                             combineLanes(lowestLanes, highestLanes));
+}
+
+ValueRange<double> interpolateSSE2(const double* from, const double* to,
+                                   double t, double* out, std::size_t count)
+{
+    __m128d factor = _mm_set1_pd(t);
+    __m128d lowest = _mm_set1_pd(std::numeric_limits<double>::infinity());
+    __m128d highest = _mm_set1_pd(-std::numeric_limits<double>::infinity());
+    std::size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128d a = _mm_loadu_pd(from + i);
+        __m128d b = _mm_loadu_pd(to + i);
+        __m128d value = _mm_add_pd(a, _mm_mul_pd(factor, _mm_sub_pd(b, a)));
+        _mm_storeu_pd(out + i, value);
+        lowest = _mm_min_pd(value, lowest);
+        highest = _mm_max_pd(value, highest);
+    }
+
+    double lowestLanes[2], highestLanes[2];
+    _mm_storeu_pd(lowestLanes, lowest);
+    _mm_storeu_pd(highestLanes, highest);
+    return interpolateScalar(from + i, to + i, t, out + i, count - i,
+                             combineLanes(lowestLanes, highestLanes));
+}
+#endif
+
+#ifdef VISZBASE_AVX2
+TARGET_AVX2 ValueRange<float> interpolateAVX2(const float* from,
+                                              const float* to, float t,
+                                              float* out, std::size_t count)
+{
+    __m256 factor = _mm256_set1_ps(t);
+    __m256 lowest = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+    __m256 highest = _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 a = _mm256_loadu_ps(from + i);
+        __m256 b = _mm256_loadu_ps(to + i);
+        __m256 value =
+            _mm256_add_ps(a, _mm256_mul_ps(factor, _mm256_sub_ps(b, a)));
+        _mm256_storeu_ps(out + i, value);
+        lowest = _mm256_min_ps(value, lowest);
+        highest = _mm256_max_ps(value, highest);
+    }
+
+    float lowestLanes[8], highestLanes[8];
+    _mm256_storeu_ps(lowestLanes, lowest);
+    _mm256_storeu_ps(highestLanes, highest);
+    return interpolateScalar(from + i, to + i, t, out + i, count - i,
+                             combineLanes(lowestLanes, highestLanes));
+}
+
+TARGET_AVX2 ValueRange<double> interpolateAVX2(const double* from,
+                                               const double* to, double t,
+                                               double* out, std::size_t count)
+{
+    __m256d factor = _mm256_set1_pd(t);
+    __m256d lowest = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+    __m256d highest =
+        _mm256_set1_pd(-std::numeric_limits<double>::infinity());
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256d a = _mm256_loadu_pd(from + i);
+        __m256d b = _mm256_loadu_pd(to + i);
+        __m256d value =
+            _mm256_add_pd(a, _mm256_mul_pd(factor, _mm256_sub_pd(b, a)));
+        _mm256_storeu_pd(out + i, value);
+        lowest = _mm256_min_pd(value, lowest);
+        highest = _mm256_max_pd(value, highest);
+    }
+
+    double lowestLanes[4], highestLanes[4];
+    _mm256_storeu_pd(lowestLanes, lowest);
+    _mm256_storeu_pd(highestLanes, highest);
+    return interpolateScalar(from + i, to + i, t, out + i, count - i,
+                             combineLanes(lowestLanes, highestLanes));
+}
+#endif
+
+InterpolationKind pickKind(InterpolationKind kind)
+{
+    // Fall back to the best available if the CPU can't run the one asked for
+    if (kind != InterpolationKind::Auto && isInterpolationSupported(kind))
+        return kind;
+    if (isInterpolationSupported(InterpolationKind::AVX2))
+        return InterpolationKind::AVX2;
+    if (isInterpolationSupported(InterpolationKind::SSE2))
+        return InterpolationKind::SSE2;
+    return InterpolationKind::Scalar;
+}
+
+template <typename T>
+ValueRange<T> interpolateWith(const T* from, const T* to, T t, T* out,
+                              std::size_t count, InterpolationKind kind)
+{
+    switch (pickKind(kind))
+    {
+#ifdef VISZBASE_AVX2
+    case InterpolationKind::AVX2:
+        return interpolateAVX2(from, to, t, out, count);
+#endif
+#ifdef VISZBASE_SSE2
+    case InterpolationKind::SSE2:
+        return interpolateSSE2(from, to, t, out, count);
+#endif
+    default:
+        return interpolateScalar(from, to, t, out, count, emptyRange<T>());
+    }
+}
+} // namespace
+
+bool isInterpolationSupported(InterpolationKind kind)
+{
+    switch (kind)
+    {
+    case InterpolationKind::Auto:
+    case InterpolationKind::Scalar:
+        return true;
+    case InterpolationKind::SSE2:
+#ifdef VISZBASE_SSE2
+        return true;
+#else
+        return false;
+#endif
+    case InterpolationKind::AVX2:
+        return cpuHasAVX2();
+    }
+    return false;
+}
+
+ValueRange<float> interpolate(const float* from, const float* to, float t,
+                              float* out, std::size_t count,
+                              InterpolationKind kind)
+{
+    return interpolateWith(from, to, t, out, count, kind);
+}
+
+ValueRange<double> interpolate(const double* from, const double* to, double t,
+                               double* out, std::size_t count,
+                               InterpolationKind kind)
+{
+    return interpolateWith(from, to, t, out, count, kind);
+}
+
+ValueRange<long double> interpolate(const long double* from,
+                                    const long double* to, long double t,
+                                    long double* out, std::size_t count,
+                                    InterpolationKind)
+{
+    return interpolateScalar(from, to, t, out, count,
+                             emptyRange<long double>());
+}
@@ -4,21 +4,37 @@
 
 // Renderer
 LineRenderer::LineRenderer(std::vector<float>& points)
-    : lineShader(
+    : lineShader(ShaderRegistry::getInstance().get(
 #include "shaders/line.vs"
           ,
 #include "shaders/line.gs"
           ,
 #include "shaders/line.fs"
-      )
+          ))
 {
     // Check the shader compiled successfully
-    if (!lineShader.getErrorMsg().empty())
+    if (!lineShader->getErrorMsg().empty())
     {
         throw std::runtime_error("Line shader error: " +
-                                 lineShader.getErrorMsg());
+                                 lineShader->getErrorMsg());
     }
 
+    glGenVertexArrays(1, &VAO);
+    glBindVertexArray(VAO);
+
+    glGenBuffers(1, &VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, (void*)0);
+
+    glBindVertexArray(0);
+
+    setPoints(points);
+}
+
+void LineRenderer::setPoints(std::vector<float>& points)
+{
     // Add the last point twice so that GL_LINE_STRIP_ADJACENY doesn't exclude
     // the last point
     if (points.size() > 1)
@@ -30,33 +46,25 @@ LineRenderer::LineRenderer(std::vector<float>& points)
 
     numOfPoints = points.size();
 
-    glGenVertexArrays(1, &VAO);
-    glBindVertexArray(VAO);
-
-    glGenBuffers(1, &VBO);
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, numOfPoints * sizeof(float), points.data(),
                  GL_STATIC_DRAW);
-
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, (void*)0);
-
-    glBindVertexArray(0);
 }
 
 void LineRenderer::draw(Color color, float aspectRatio, float lineThickness,
                         const math::Matrix<4, 4>& proj)
 {
     glBindVertexArray(VAO);
-    glUseProgram(lineShader.getProgram());
+    glUseProgram(lineShader->getProgram());
 
     // Send shader values
-    glUniformMatrix4fv(lineShader.getUniformLocation("matrix"), 1, GL_TRUE,
+    glUniformMatrix4fv(lineShader->getUniformLocation("matrix"), 1, GL_TRUE,
                        *proj);
-    glUniform4f(lineShader.getUniformLocation("color"), color.r, color.g,
+    glUniform4f(lineShader->getUniformLocation("color"), color.r, color.g,
                 color.b, color.a);
-    glUniform1f(lineShader.getUniformLocation("aspectRatio"), aspectRatio);
-    glUniform1f(lineShader.getUniformLocation("lineThickness"), lineThickness);
+    glUniform1f(lineShader->getUniformLocation("aspectRatio"), aspectRatio);
+    glUniform1f(lineShader->getUniformLocation("lineThickness"),
+                lineThickness);
 
     // Draw
     glDrawArrays(GL_LINE_STRIP_ADJACENCY, 0, numOfPoints / 2);
@@ -70,3 +78,8 @@ void LineRendererBuilder::addPoint(float x, float y)
 }
 
 LineRenderer LineRendererBuilder::build() { return LineRenderer(points); }
+
+void LineRendererBuilder::rebuild(LineRenderer& renderer)
+{
+    renderer.setPoints(points);
+}
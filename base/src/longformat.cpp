@@ -0,0 +1,101 @@
+#include "viszbase/longformat.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace
+{
+constexpr Value Missing = std::numeric_limits<Value>::quiet_NaN();
+
+// Reads the whole of the text as a number, returns false if it isn't one
+bool readWholeNumber(std::string_view text, double& number)
+{
+    auto result =
+        std::from_chars(text.data(), text.data() + text.size(), number);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+// Numbers go before anything else, and are compared by value
+bool categoryLess(std::string_view a, std::string_view b)
+{
+    double numberA, numberB;
+    bool isNumberA = readWholeNumber(a, numberA);
+    bool isNumberB = readWholeNumber(b, numberB);
+    if (isNumberA && isNumberB && numberA != numberB)
+        return numberA < numberB;
+    if (isNumberA != isNumberB)
+        return isNumberA;
+    return a < b;
+}
+} // namespace
+
+void LongFormatPivot::add(std::string_view name, std::string_view category,
+                          Value value)
+{
+    StringId categoryId;
+    if (categoryNames.size() > 0 && category == categoryNames.get(lastCategory))
+        categoryId = lastCategory;
+    else
+    {
+        categoryId = categoryNames.intern(category);
+        lastCategory = categoryId;
+        // A new category most likely has values for the names already seen,
+        // so make room for them up front rather than growing one at a time
+        if (categoryId == columns.size())
+            columns.emplace_back().reserve(names.size());
+    }
+    StringId nameId = names.intern(name);
+
+    // Columns only grow to fit the names given values in them, the rest are
+    // filled in when finishing
+    auto& column = columns[categoryId];
+    if (nameId >= column.size())
+        column.resize(nameId + 1, Missing);
+    column[nameId] = value;
+}
+
+void LongFormatPivot::finish(CategoryOrder order,
+                             std::vector<std::string>& categories,
+                             Dataset& dataset)
+{
+    std::vector<StringId> sorted(categoryNames.size());
+    std::iota(sorted.begin(), sorted.end(), 0);
+    if (order == CategoryOrder::Sorted)
+        std::stable_sort(sorted.begin(), sorted.end(),
+                         [&](StringId a, StringId b)
+                         {
+                             return categoryLess(categoryNames.get(a),
+                                                 categoryNames.get(b));
+                         });
+
+    // Build it category major, as that's how the columns already are, and
+    // free each column once it's copied
+    std::size_t rowCount = names.size();
+    std::vector<Value> values(rowCount * sorted.size());
+    categories.clear();
+    for (std::size_t c = 0; c < sorted.size(); c++)
+    {
+        std::vector<Value>& column = columns[sorted[c]];
+        Value* out = values.data() + c * rowCount;
+        for (std::size_t r = 0; r < rowCount; r++)
+        {
+            Value value = (r < column.size()) ? column[r] : Missing;
+            if (std::isnan(value))
+                value = (c == 0) ? 0 : values[(c - 1) * rowCount + r];
+            out[r] = value;
+        }
+        std::vector<Value>().swap(column);
+        categories.emplace_back(categoryNames.get(sorted[c]));
+    }
+
+    DatasetLayout layout = dataset.getLayout();
+    dataset = Dataset(DatasetLayout::CategoryMajor);
+    dataset.setCategoryCount(categories.size());
+    dataset.setRows(std::move(names), std::move(values));
+    dataset.setLayout(layout);
+
+    *this = LongFormatPivot();
+}
@@ -0,0 +1,101 @@
+#include "viszbase/mappedfile.hpp"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string& fileName)
+{
+    fileHandle = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                             NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN,
+                             NULL);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+        throw std::runtime_error("Failed to open file: " + fileName);
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize))
+    {
+        CloseHandle(fileHandle);
+        throw std::runtime_error("Failed to get size of file: " + fileName);
+    }
+    size = fileSize.QuadPart;
+
+    // Empty files can't be mapped, leave the view empty instead
+    if (size == 0)
+        return;
+
+    mappingHandle =
+        CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mappingHandle == NULL)
+    {
+        CloseHandle(fileHandle);
+        throw std::runtime_error("Failed to map file: " + fileName);
+    }
+
+    data = static_cast<const char*>(
+        MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (data == nullptr)
+    {
+        CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+        throw std::runtime_error("Failed to map file: " + fileName);
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if (data)
+        UnmapViewOfFile(data);
+    if (mappingHandle)
+        CloseHandle(mappingHandle);
+    CloseHandle(fileHandle);
+}
+#else
+MappedFile::MappedFile(const std::string& fileName)
+{
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd == -1)
+        throw std::runtime_error("Failed to open file: " + fileName);
+
+    struct stat fileInfo;
+    if (fstat(fd, &fileInfo) == -1 || !S_ISREG(fileInfo.st_mode))
+    {
+        close(fd);
+        throw std::runtime_error("Failed to map file: " + fileName);
+    }
+    size = fileInfo.st_size;
+
+    // Empty files can't be mapped, leave the view empty instead
+    if (size == 0)
+    {
+        close(fd);
+        return;
+    }
+
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file
+    close(fd);
+    if (mapping == MAP_FAILED)
+        throw std::runtime_error("Failed to map file: " + fileName);
+
+    // The file is read from front to back, let the kernel read ahead
+    madvise(mapping, size, MADV_SEQUENTIAL);
+    data = static_cast<const char*>(mapping);
+}
+
+MappedFile::~MappedFile()
+{
+    if (data)
+        munmap(const_cast<char*>(data), size);
+}
+#endif
@@ -0,0 +1,354 @@
+#include "viszbase/numberparser.hpp"
+
+#include <charconv>
+#include <cstdint>
+#include <limits>
+
+namespace
+{
+// Most digits kept for the slow path, enough to round correctly
+constexpr int MaxSlowDigits = 768;
+
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' ||
+           c == '\f';
+}
+
+// Whether every 'sep' in the text groups digits, with 1 to 3 digits before
+// the first and exactly 3 after each
+bool isGrouped(std::string_view text, char sep)
+{
+    std::size_t first = text.find(sep);
+    if (first == std::string_view::npos)
+        return false;
+    std::size_t digitsBefore = 0;
+    while (digitsBefore < first && isDigit(text[first - 1 - digitsBefore]))
+        ++digitsBefore;
+    if (digitsBefore == 0 || digitsBefore > 3)
+        return false;
+
+    for (std::size_t pos = first; pos != std::string_view::npos;
+         pos = text.find(sep, pos + 1))
+    {
+        std::size_t digitsAfter = 0;
+        while (pos + 1 + digitsAfter < text.size() &&
+               isDigit(text[pos + 1 + digitsAfter]))
+            ++digitsAfter;
+        if (digitsAfter != 3)
+            return false;
+    }
+    return true;
+}
+
+// The largest power of ten that T holds exactly, 10^n is exact as long as
+// 5^n fits in T's mantissa
+template <typename T> constexpr int maxExactPowerOfTen()
+{
+    int power = 0;
+    long double five = 1;
+    long double limit = 1;
+    for (int i = 0; i < std::numeric_limits<T>::digits && i < 64; i++)
+        limit *= 2;
+    while (five * 5 < limit && power < 27)
+    {
+        five *= 5;
+        ++power;
+    }
+    return power;
+}
+
+// The largest mantissa T holds exactly
+template <typename T> constexpr std::uint64_t maxExactMantissa()
+{
+    return std::numeric_limits<T>::digits >= 64
+               ? std::numeric_limits<std::uint64_t>::max()
+               : (std::uint64_t(1) << std::numeric_limits<T>::digits);
+}
+
+template <typename T> T powerOfTen(int power)
+{
+    T result = 1;
+    for (int i = 0; i < power; i++)
+        result *= 10;
+    return result;
+}
+
+template <typename T> struct PowersOfTen
+{
+    T values[maxExactPowerOfTen<T>() + 1];
+
+    PowersOfTen()
+    {
+        for (int i = 0; i <= maxExactPowerOfTen<T>(); i++)
+            values[i] = powerOfTen<T>(i);
+    }
+};
+
+// Rewrites the number in the form std::from_chars expects, and parses it
+// with that. Only needed when the mantissa or exponent is too large for the
+// fast path to be exact. If the number is out of T's range, it becomes T's
+// largest value if 'large' is set, and 0 otherwise
+template <typename T>
+T parseSlow(const char* begin, const char* end, const NumberFormat& format,
+            bool large)
+{
+    // The significant digits, with no decimal point, then the exponent that
+    // puts it back in place
+    char buffer[MaxSlowDigits + 32];
+    int length = 0;
+    int digits = 0;
+    long long exponent = 0;
+    bool negative = false;
+    bool inFraction = false;
+
+    const char* p = begin;
+    for (; p != end && *p != 'e' && *p != 'E'; ++p)
+    {
+        char c = *p;
+        if (c == '-')
+        {
+            negative = true;
+            buffer[length++] = '-';
+        }
+        else if (c == format.decimalPoint)
+            inFraction = true;
+        else if (!isDigit(c) || (digits == 0 && c == '0'))
+        {
+            // Leading zeros only move the decimal point
+            if (isDigit(c) && inFraction)
+                --exponent;
+        }
+        // Digits past this many can't change the result, but those in the
+        // whole part still count towards its size
+        else if (digits < MaxSlowDigits)
+        {
+            buffer[length++] = c;
+            ++digits;
+            if (inFraction)
+                --exponent;
+        }
+        else if (!inFraction)
+            ++exponent;
+    }
+    if (digits == 0)
+        buffer[length++] = '0';
+
+    // The written exponent, parseNumber only leaves one in with digits
+    if (p != end)
+    {
+        bool negativeExponent = false;
+        long long written = 0;
+        for (++p; p != end; ++p)
+        {
+            if (*p == '-')
+                negativeExponent = true;
+            // Anything this large is out of range anyway
+            else if (isDigit(*p) && written < 100000)
+                written = written * 10 + (*p - '0');
+        }
+        exponent += negativeExponent ? -written : written;
+    }
+    buffer[length++] = 'e';
+    char* bufferEnd =
+        std::to_chars(buffer + length, buffer + sizeof(buffer), exponent).ptr;
+
+    T value = 0;
+    auto result = std::from_chars(buffer, bufferEnd, value);
+    if (result.ec == std::errc::result_out_of_range)
+    {
+        value = large ? std::numeric_limits<T>::max() : 0;
+        if (negative)
+            value = -value;
+    }
+    return value;
+}
+} // namespace
+
+NumberFormat NumberFormat::fromLocale(const std::locale& locale)
+{
+    const auto& punct = std::use_facet<std::numpunct<char>>(locale);
+
+    NumberFormat format;
+    format.decimalPoint = punct.decimal_point();
+    // Only group digits if the locale actually groups them
+    if (!punct.grouping().empty())
+        format.thousandsSeparator = punct.thousands_sep();
+    return format;
+}
+
+NumberFormat detectNumberFormat(const std::vector<std::string_view>& cells,
+                                const NumberFormat& fallback)
+{
+    for (std::string_view cell : cells)
+    {
+        std::size_t lastDot = cell.rfind('.');
+        std::size_t lastComma = cell.rfind(',');
+
+        // With both, whichever comes last is the decimal point, as long as
+        // the other groups the digits before it
+        if (lastDot != std::string_view::npos &&
+            lastComma != std::string_view::npos)
+        {
+            if (lastDot > lastComma && isGrouped(cell.substr(0, lastDot), ','))
+                return NumberFormat{'.', ','};
+            if (lastComma > lastDot &&
+                isGrouped(cell.substr(0, lastComma), '.'))
+                return NumberFormat{',', '.'};
+            continue;
+        }
+
+        // With just one of them, it must be grouping if it appears twice, or
+        // if it is followed by anything other than exactly 3 digits then it
+        // must be the decimal point
+        for (char sep : {'.', ','})
+        {
+            std::size_t first = cell.find(sep);
+            if (first == std::string_view::npos)
+                continue;
+            char other = (sep == '.') ? ',' : '.';
+
+            if (first != cell.rfind(sep))
+            {
+                if (isGrouped(cell, sep))
+                    return NumberFormat{other, sep};
+                continue;
+            }
+
+            std::size_t digitsAfter = 0;
+            while (first + 1 + digitsAfter < cell.size() &&
+                   isDigit(cell[first + 1 + digitsAfter]))
+                ++digitsAfter;
+            if (digitsAfter != 3)
+                return NumberFormat{sep, fallback.thousandsSeparator == sep
+                                             ? char(0)
+                                             : fallback.thousandsSeparator};
+        }
+    }
+    return fallback;
+}
+
+template <typename T>
+T parseNumber(std::string_view text, const NumberFormat& format)
+{
+    static const PowersOfTen<T> powers;
+
+    const char* p = text.data();
+    const char* end = p + text.size();
+
+    while (p != end && isSpace(*p))
+        ++p;
+    const char* begin = p;
+
+    bool negative = false;
+    if (p != end && (*p == '-' || *p == '+'))
+    {
+        negative = (*p == '-');
+        ++p;
+    }
+
+    // Read the digits into a 64 bit mantissa, while there's room for them.
+    // 'exponent' is the power of ten the mantissa needs multiplying by
+    std::uint64_t mantissa = 0;
+    int significantDigits = 0;
+    int exponent = 0;
+    bool anyDigits = false;
+    bool exact = true;
+
+    auto addDigit = [&](int digit)
+    {
+        anyDigits = true;
+        if (significantDigits < 19)
+        {
+            mantissa = mantissa * 10 + digit;
+            if (mantissa != 0)
+                ++significantDigits;
+            return true;
+        }
+        if (digit != 0)
+            exact = false;
+        return false;
+    };
+
+    // Whole part, which may have its digits grouped
+    while (p != end)
+    {
+        if (isDigit(*p))
+        {
+            if (!addDigit(*p - '0'))
+                ++exponent;
+        }
+        else if (*p != format.thousandsSeparator || !anyDigits ||
+                 format.thousandsSeparator == 0 || p + 1 == end ||
+                 !isDigit(p[1]))
+            break;
+        ++p;
+    }
+
+    // Fractional part
+    if (p != end && *p == format.decimalPoint)
+    {
+        ++p;
+        while (p != end && isDigit(*p))
+        {
+            if (addDigit(*p - '0'))
+                --exponent;
+            ++p;
+        }
+    }
+
+    if (!anyDigits)
+        return 0;
+
+    // Exponent, only if there are digits after the 'e'
+    if (p != end && (*p == 'e' || *p == 'E'))
+    {
+        const char* e = p + 1;
+        bool negativeExponent = false;
+        if (e != end && (*e == '-' || *e == '+'))
+        {
+            negativeExponent = (*e == '-');
+            ++e;
+        }
+        if (e != end && isDigit(*e))
+        {
+            int written = 0;
+            for (; e != end && isDigit(*e); ++e)
+            {
+                // Anything this large is out of range anyway
+                if (written < 100000)
+                    written = written * 10 + (*e - '0');
+            }
+            exponent += negativeExponent ? -written : written;
+            p = e;
+        }
+    }
+
+    // If the mantissa and the power of ten are both exact, then a single
+    // multiply or divide gives a correctly rounded result
+    if (exact && mantissa <= maxExactMantissa<T>() &&
+        exponent >= -maxExactPowerOfTen<T>() &&
+        exponent <= maxExactPowerOfTen<T>())
+    {
+        T value = T(mantissa);
+        if (exponent < 0)
+            value /= powers.values[-exponent];
+        else
+            value *= powers.values[exponent];
+        return negative ? -value : value;
+    }
+
+    if (mantissa == 0 && exact)
+        return negative ? -T(0) : T(0);
+
+    // Out of range numbers are either huge or tiny, which one depends on the
+    // position of the first significant digit
+    return parseSlow<T>(begin, p, format, significantDigits + exponent > 0);
+}
+
+template float parseNumber<float>(std::string_view, const NumberFormat&);
+template double parseNumber<double>(std::string_view, const NumberFormat&);
+template long double parseNumber<long double>(std::string_view,
+                                              const NumberFormat&);
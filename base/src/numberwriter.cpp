@@ -0,0 +1,66 @@
+#include "viszbase/numberwriter.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <tuple>
+
+namespace
+{
+constexpr int MaxDecimalPoints = 32;
+// Grouping adds a separator for every 3 digits, so the digits are kept to
+// what still fits in the buffer once they're added
+constexpr int MaxDigitsLength = std::tuple_size<NumberBuffer>::value * 3 / 4;
+
+std::to_chars_result toChars(char* digits, long double number,
+                             int decimalPoints, std::chars_format format)
+{
+    // Writing a long double is several times slower, and the values shown
+    // are usually doubles anyway, which give the same digits
+    double asDouble = number;
+    if (asDouble == number || number != number)
+        return std::to_chars(digits, digits + MaxDigitsLength, asDouble,
+                             format, decimalPoints);
+    return std::to_chars(digits, digits + MaxDigitsLength, number, format,
+                         decimalPoints);
+}
+} // namespace
+
+std::string_view writeNumber(long double number, int decimalPoints,
+                             const NumberFormat& format, NumberBuffer& buffer)
+{
+    decimalPoints = std::clamp(decimalPoints, 0, MaxDecimalPoints);
+
+    char digits[MaxDigitsLength];
+    std::to_chars_result result = toChars(digits, number, decimalPoints,
+                                          std::chars_format::fixed);
+    if (result.ec != std::errc())
+        result = toChars(digits, number, decimalPoints,
+                         std::chars_format::scientific);
+    const char* begin = digits;
+    const char* end = result.ptr;
+
+    char* out = buffer.data();
+    if (begin != end && *begin == '-')
+        *out++ = *begin++;
+
+    // The whole part is grouped, starting from the decimal point
+    const char* whole = std::find_if(begin, end, [](char c)
+                                     { return c == '.' || c == 'e'; });
+    for (const char* p = begin; p != whole; ++p)
+    {
+        if (p != begin && format.thousandsSeparator && (whole - p) % 3 == 0)
+            *out++ = format.thousandsSeparator;
+        *out++ = *p;
+    }
+    for (const char* p = whole; p != end; ++p)
+        *out++ = (*p == '.') ? format.decimalPoint : *p;
+
+    return std::string_view(buffer.data(), out - buffer.data());
+}
+
+const NumberFormat& getSystemNumberFormat()
+{
+    static const NumberFormat format =
+        NumberFormat::fromLocale(std::locale(""));
+    return format;
+}
@@ -0,0 +1,159 @@
+#include "viszbase/programcache.hpp"
+
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "glad/gl.hpp"
+#include "viszbase/cachedirectory.hpp"
+#include "viszbase/hash.hpp"
+#include "viszbase/mappedfile.hpp"
+#include "viszbase/tempfile.hpp"
+
+namespace
+{
+constexpr char Magic[8] = {'N', 'V', 'Z', 'P', 'R', 'O', 'G', 'R'};
+// Changed whenever the layout of the file changes
+constexpr std::uint32_t Version = 1;
+
+bool cacheEnabled = true;
+
+// Followed by the binary
+struct Header
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t binaryFormat;
+    std::uint64_t sourceHash;
+    std::uint64_t driverHash;
+    std::uint64_t binaryLength;
+};
+
+std::uint64_t hashString(std::uint64_t hash, const char* str)
+{
+    // Hash the terminating null too, so the strings are kept apart
+    return str ? hashBytes(hash, str, std::strlen(str) + 1) : hash;
+}
+} // namespace
+
+ProgramCache::ProgramCache(const char* vsSource, const char* gsSource,
+                           const char* fsSource)
+{
+    sourceHash = hashString(HashStart, vsSource);
+    sourceHash = hashString(sourceHash, gsSource ? gsSource : "");
+    sourceHash = hashString(sourceHash, fsSource);
+
+    // A binary is only any use to the same driver on the same hardware
+    driverHash = HashStart;
+    for (GLenum string : {GL_VENDOR, GL_RENDERER, GL_VERSION})
+        driverHash = hashString(
+            driverHash, reinterpret_cast<const char*>(glGetString(string)));
+
+    char name[16];
+    std::uint64_t nameHash = sourceHash ^ (driverHash * 31);
+    auto result = std::to_chars(name, name + sizeof(name), nameHash, 16);
+    path = (getCacheDirectory() / std::string(name, result.ptr)).string() +
+           ".nvzprogram";
+}
+
+bool ProgramCache::isAvailable()
+{
+    if (!cacheEnabled || !GLAD_GL_ARB_get_program_binary)
+        return false;
+    int formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+void ProgramCache::setEnabled(bool enabled) { cacheEnabled = enabled; }
+
+void ProgramCache::prepare(unsigned program)
+{
+    glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+bool ProgramCache::load(unsigned program) const
+{
+    std::unique_ptr<MappedFile> file;
+    try
+    {
+        file = std::make_unique<MappedFile>(path);
+    }
+    catch (std::runtime_error&)
+    {
+        return false;
+    }
+
+    const char* data = file->getData();
+    std::size_t size = file->getSize();
+    Header header;
+    if (size < sizeof(header))
+        return false;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 ||
+        header.version != Version || header.sourceHash != sourceHash ||
+        header.driverHash != driverHash ||
+        header.binaryLength != size - sizeof(header))
+        return false;
+
+    glProgramBinary(program, header.binaryFormat, data + sizeof(header),
+                    header.binaryLength);
+    int status = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    return status;
+}
+
+bool ProgramCache::save(unsigned program) const
+{
+    int length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return false;
+
+    std::vector<char> binary(length);
+    GLenum binaryFormat = 0;
+    glGetProgramBinary(program, length, &length, &binaryFormat,
+                       binary.data());
+    if (length <= 0)
+        return false;
+
+    Header header{};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.binaryFormat = binaryFormat;
+    header.sourceHash = sourceHash;
+    header.driverHash = driverHash;
+    header.binaryLength = length;
+
+    // Write to a temporary file and then move it into place, so a cache
+    // file is either complete or not there at all, even with another
+    // process saving it too
+    std::string tempPath = getTempPath(path);
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open())
+            return false;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(binary.data(), length);
+        if (!out.good())
+        {
+            out.close();
+            std::error_code error;
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error)
+    {
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
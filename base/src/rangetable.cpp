@@ -0,0 +1,43 @@
+#include "viszbase/rangetable.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+constexpr ValueRange<Value> EmptyRange{
+    std::numeric_limits<Value>::infinity(),
+    -std::numeric_limits<Value>::infinity()};
+} // namespace
+
+RangeTable::RangeTable(const Dataset& dataset)
+    : prefixes(dataset.getCategoryCount(), EmptyRange)
+{
+    addRows(dataset, 0);
+}
+
+void RangeTable::addRows(const Dataset& dataset, std::size_t firstRow)
+{
+    // The range over categories 0 to c of every row is that of the rows
+    // already there widened by that of the new ones, so only the new rows
+    // are gone through
+    ValueRange<Value> added = EmptyRange;
+    for (std::size_t c = 0; c < prefixes.size(); c++)
+    {
+        const Value* values = dataset.getCategory(c);
+        for (std::size_t r = firstRow; r < dataset.getRowCount(); r++)
+        {
+            added.lowest = std::min(added.lowest, values[r]);
+            added.highest = std::max(added.highest, values[r]);
+        }
+        prefixes[c].lowest = std::min(prefixes[c].lowest, added.lowest);
+        prefixes[c].highest = std::max(prefixes[c].highest, added.highest);
+    }
+}
+
+ValueRange<Value> RangeTable::getRange(std::size_t last) const
+{
+    if (prefixes.empty())
+        return EmptyRange;
+    return prefixes[std::min(last, prefixes.size() - 1)];
+}
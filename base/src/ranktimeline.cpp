@@ -0,0 +1,115 @@
+#include "viszbase/ranktimeline.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+#include "viszbase/threadpool.hpp"
+
+namespace
+{
+constexpr Value NoFloor = -std::numeric_limits<Value>::infinity();
+
+// The values at either end of the interval starting at 'category'. With a
+// single category, the interval starts and ends at it
+void getEnds(const Dataset& dataset, std::size_t category, const Value*& from,
+             const Value*& to)
+{
+    from = dataset.getCategory(category);
+    to = dataset.getCategory(
+        std::min(category + 1, dataset.getCategoryCount() - 1));
+}
+} // namespace
+
+RankTimeline::RankTimeline(const Dataset& dataset, std::size_t depth,
+                           unsigned threads)
+    : depth{std::max<std::size_t>(depth, 1)}, threads{threads}
+{
+    build(dataset);
+}
+
+void RankTimeline::addRows(const Dataset& dataset, std::size_t firstRow)
+{
+    // Once there are twice as many rows as when it was built, the floors
+    // are likely to be well below where they could be, so build it again
+    if (dataset.getRowCount() >= builtRowCount * 2)
+    {
+        build(dataset);
+        return;
+    }
+
+    for (std::size_t c = 0; c < intervals.size(); c++)
+    {
+        // Adding rows can only raise the floor, so the old one still lets in
+        // every row that could be in the top. It isn't raised, as that would
+        // mean looking at every row again
+        Interval& interval = intervals[c];
+        std::size_t sorted = interval.candidates.size();
+        const Value *from, *to;
+        getEnds(dataset, c, from, to);
+        for (std::size_t r = firstRow; r < dataset.getRowCount(); r++)
+            if (std::max(from[r], to[r]) >= interval.floor)
+                interval.candidates.push_back(r);
+        sortCandidates(dataset, c, sorted);
+    }
+}
+
+void RankTimeline::build(const Dataset& dataset)
+{
+    builtRowCount = dataset.getRowCount();
+    intervals.clear();
+    if (dataset.getCategoryCount() == 0)
+        return;
+
+    intervals.resize(std::max<std::size_t>(dataset.getCategoryCount(), 2) - 1);
+    ThreadPool pool(threads);
+    pool.run(intervals.size(),
+             [&](std::size_t c) { buildInterval(dataset, c); });
+}
+
+void RankTimeline::buildInterval(const Dataset& dataset, std::size_t category)
+{
+    std::size_t rowCount = dataset.getRowCount();
+    const Value *from, *to;
+    getEnds(dataset, category, from, to);
+
+    Interval& interval = intervals[category];
+    interval.candidates.clear();
+    if (rowCount <= depth)
+    {
+        // Every row is in the top
+        interval.floor = NoFloor;
+        for (std::size_t r = 0; r < rowCount; r++)
+            interval.candidates.push_back(r);
+    }
+    else
+    {
+        // The floor is the depth'th highest of the lowest values rows have
+        std::vector<Value> lows(rowCount);
+        for (std::size_t r = 0; r < rowCount; r++)
+            lows[r] = std::min(from[r], to[r]);
+        std::nth_element(lows.begin(), lows.begin() + depth - 1, lows.end(),
+                         std::greater<Value>());
+        interval.floor = lows[depth - 1];
+
+        for (std::size_t r = 0; r < rowCount; r++)
+            if (std::max(from[r], to[r]) >= interval.floor)
+                interval.candidates.push_back(r);
+    }
+    sortCandidates(dataset, category);
+}
+
+void RankTimeline::sortCandidates(const Dataset& dataset, std::size_t category,
+                                  std::size_t sorted)
+{
+    const Value* from = dataset.getCategory(category);
+    auto higher = [&](std::uint32_t a, std::uint32_t b)
+    { return from[a] > from[b] || (from[a] == from[b] && a < b); };
+
+    // Only the candidates after those already sorted are sorted, then the
+    // two are merged
+    std::vector<std::uint32_t>& candidates = intervals[category].candidates;
+    std::sort(candidates.begin() + sorted, candidates.end(), higher);
+    std::inplace_merge(candidates.begin(), candidates.begin() + sorted,
+                       candidates.end(), higher);
+}
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cstddef>
 #include <stdexcept>
 
 #include <glad/gl.hpp>
@@ -5,17 +7,17 @@
 #include "viszbase/renderer.hpp"
 
 Renderer::Renderer()
-    : rectShader(
+    : rectShader(ShaderRegistry::getInstance().get(
 #include "shaders/rect.vs"
           ,
 #include "shaders/rect.fs"
-      )
+          ))
 {
     // Check the shader compiled successfully
-    if (!rectShader.getErrorMsg().empty())
+    if (!rectShader->getErrorMsg().empty())
     {
         throw std::runtime_error("Rect shader error: " +
-                                 rectShader.getErrorMsg());
+                                 rectShader->getErrorMsg());
     }
 
     // Configure rectangle vertex buffer
@@ -32,24 +34,60 @@ Renderer::Renderer()
 
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+
+    // The boxes go in a buffer of their own, moving on once per box rather
+    // than once per vertex
+    glGenBuffers(1, &instanceVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Box),
+                          (void*)offsetof(Box, x));
+    glVertexAttribDivisor(1, 1);
+
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Box),
+                          (void*)offsetof(Box, color));
+    glVertexAttribDivisor(2, 1);
+
+    glBindVertexArray(0);
 }
 
 void Renderer::drawBox(float x, float y, float x1, float y1, Color color,
                        math::Matrix<4, 4>& projection)
 {
-    glUseProgram(rectShader.getProgram());
-    // Setup matrices
-    math::setTranslate(translate, x, y, 0.0f);
-    math::setScale(scale, (x1 - x), (y1 - y), 1.0f);
-    result = projection * translate * scale;
-    // Send data to shader
-    glUniformMatrix4fv(rectShader.getUniformLocation("matrix"), 1, GL_TRUE,
-                       *result);
-    glUniform4f(rectShader.getUniformLocation("color"), color.r, color.g,
-                color.b, color.a);
-
-    // Draw the rectangle
+    queueBox(x, y, x1, y1, color);
+    flush(projection);
+}
+
+void Renderer::queueBox(float x, float y, float x1, float y1, Color color)
+{
+    boxes.push_back({x, y, x1 - x, y1 - y, color});
+}
+
+void Renderer::flush(const math::Matrix<4, 4>& projection)
+{
+    if (boxes.empty())
+        return;
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    // Give the buffer new storage each time, rather than wait for the GPU
+    // to finish drawing from the old one
+    if (boxes.size() > instanceCapacity)
+        instanceCapacity = std::max(boxes.size(), instanceCapacity * 2);
+    glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(Box), nullptr,
+                 GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, boxes.size() * sizeof(Box),
+                    boxes.data());
+
+    glUseProgram(rectShader->getProgram());
+    glUniformMatrix4fv(rectShader->getUniformLocation("matrix"), 1, GL_TRUE,
+                       *projection);
+
+    // Draw every box at once
     glBindVertexArray(VAO);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, boxes.size());
     glBindVertexArray(0);
+
+    boxes.clear();
 }
@@ -2,6 +2,10 @@
 
 #include "viszbase/shader.hpp"
 
+#include <optional>
+
+#include "viszbase/programcache.hpp"
+
 unsigned Shader::createShader(unsigned shaderType, const char* source)
 {
     // Compile the shader
@@ -39,52 +43,42 @@ unsigned Shader::createShader(unsigned shaderType, const char* source)
 
 Shader::Shader(const char* vsSource, const char* fsSource)
 {
-    // Compile the vertex shader
-    unsigned vShader = createShader(GL_VERTEX_SHADER, vsSource);
-
-    // Compile the fragment shader
-    unsigned fShader = createShader(GL_FRAGMENT_SHADER, fsSource);
+    build(vsSource, nullptr, fsSource);
+}
 
-    // Link the program
-    int status;
-    char msg[1024];
+Shader::Shader(const char* vsSource, const char* gsSource, const char* fsSource)
+{
+    build(vsSource, gsSource, fsSource);
+}
 
+void Shader::build(const char* vsSource, const char* gsSource,
+                   const char* fsSource)
+{
     program = glCreateProgram();
-    glAttachShader(program, vShader);
-    glAttachShader(program, fShader);
-    glLinkProgram(program);
 
-    glGetProgramiv(program, GL_LINK_STATUS, &status);
-    if (!status)
+    // Load the program the driver built last time, if it'll take it
+    std::optional<ProgramCache> cache;
+    if (ProgramCache::isAvailable())
     {
-        glGetProgramInfoLog(program, 1024, NULL, msg);
-        errorMsg += "\nProgram failed to link:\n";
-        errorMsg += msg;
-        errorMsg += '\n';
+        cache.emplace(vsSource, gsSource, fsSource);
+        if (cache->load(program))
+            return;
+        ProgramCache::prepare(program);
     }
 
-    glDeleteShader(vShader);
-    glDeleteShader(fShader);
-}
-
-Shader::Shader(const char* vsSource, const char* gsSource, const char* fsSource)
-{
-    // Compile the vertex shader
+    // Compile the shaders, the geometry shader is optional
     unsigned vShader = createShader(GL_VERTEX_SHADER, vsSource);
-
-    // Compile the geometry shader
-    unsigned gShader = createShader(GL_GEOMETRY_SHADER, gsSource);
-
-    // Compile the fragment shader
+    unsigned gShader = gsSource ? createShader(GL_GEOMETRY_SHADER, gsSource)
+                                : 0;
     unsigned fShader = createShader(GL_FRAGMENT_SHADER, fsSource);
 
     // Link the program
     int status;
     char msg[1024];
 
-    program = glCreateProgram();
     glAttachShader(program, vShader);
-    glAttachShader(program, gShader);
+    if (gShader)
+        glAttachShader(program, gShader);
     glAttachShader(program, fShader);
     glLinkProgram(program);
 
@@ -98,10 +92,16 @@ Shader::Shader(const char* vsSource, const char* gsSource, const char* fsSource)
     }
 
     glDeleteShader(vShader);
-    glDeleteShader(gShader);
+    if (gShader)
+        glDeleteShader(gShader);
     glDeleteShader(fShader);
+
+    if (cache && errorMsg.empty())
+        cache->save(program);
 }
 
+Shader::~Shader() { glDeleteProgram(program); }
+
 unsigned Shader::getUniformLocation(const std::string& name)
 {
     // Look for the corresponding uniform location
@@ -116,3 +116,39 @@ unsigned Shader::getUniformLocation(const std::string& name)
     uniformLocations[name] = glGetUniformLocation(program, name.c_str());
     return uniformLocations[name];
 }
+
+ShaderRegistry& ShaderRegistry::getInstance()
+{
+    static ShaderRegistry instance;
+    return instance;
+}
+
+std::shared_ptr<Shader> ShaderRegistry::get(const char* vsSource,
+                                            const char* fsSource)
+{
+    return get(vsSource, nullptr, fsSource);
+}
+
+std::shared_ptr<Shader> ShaderRegistry::get(const char* vsSource,
+                                            const char* gsSource,
+                                            const char* fsSource)
+{
+    // Sources can't hold a null, so it keeps them apart
+    std::string key = vsSource;
+    key += '\0';
+    if (gsSource)
+        key += gsSource;
+    key += '\0';
+    key += fsSource;
+
+    std::shared_ptr<Shader> shader = programs[key].lock();
+    if (!shader)
+    {
+        if (gsSource)
+            shader = std::make_shared<Shader>(vsSource, gsSource, fsSource);
+        else
+            shader = std::make_shared<Shader>(vsSource, fsSource);
+        programs[key] = shader;
+    }
+    return shader;
+}
@@ -0,0 +1,31 @@
+#include "viszbase/simd.hpp"
+
+namespace
+{
+bool checkAVX2()
+{
+#ifndef VISZBASE_AVX2
+    return false;
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    // The OS must also save the AVX registers on context switches
+    __cpuid(info, 1);
+    bool osxsave = info[2] & (1 << 27);
+    if (!osxsave || (_xgetbv(0) & 0x6) != 0x6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return info[1] & (1 << 5);
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+} // namespace
+
+bool cpuHasAVX2()
+{
+    static const bool hasAVX2 = checkAVX2();
+    return hasAVX2;
+}
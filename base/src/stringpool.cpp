@@ -0,0 +1,98 @@
+#include "viszbase/stringpool.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+
+namespace
+{
+// Strings are packed into blocks of this size, a string too long to share a
+// block is given one of its own
+constexpr std::size_t BlockSize = 64 * 1024;
+constexpr std::size_t MaxSharedSize = BlockSize / 4;
+
+constexpr StringId EmptySlot = std::numeric_limits<StringId>::max();
+constexpr std::size_t MinSlots = 16;
+} // namespace
+
+StringId StringPool::intern(std::string_view str)
+{
+    if ((strings.size() + 1) * 2 > slots.size())
+        growSlots();
+
+    std::size_t slot = findSlot(str);
+    if (slots[slot] != EmptySlot)
+        return slots[slot];
+
+    StringId id = strings.size();
+    strings.emplace_back(store(str), str.size());
+    slots[slot] = id;
+    return id;
+}
+
+bool StringPool::find(std::string_view str, StringId& id) const
+{
+    if (slots.empty())
+        return false;
+
+    std::size_t slot = findSlot(str);
+    if (slots[slot] == EmptySlot)
+        return false;
+    id = slots[slot];
+    return true;
+}
+
+std::size_t StringPool::getMemoryUsage() const
+{
+    return blocksSize + strings.capacity() * sizeof(std::string_view) +
+           slots.capacity() * sizeof(StringId);
+}
+
+const char* StringPool::store(std::string_view str)
+{
+    std::size_t size = str.size() + 1;
+    char* destination;
+    if (size > MaxSharedSize)
+    {
+        // What's left of the last block is still used for the next strings
+        blocks.push_back(std::make_unique<char[]>(size));
+        blocksSize += size;
+        destination = blocks.back().get();
+    }
+    else
+    {
+        if (size > freeSize)
+        {
+            blocks.push_back(std::make_unique<char[]>(BlockSize));
+            blocksSize += BlockSize;
+            nextFree = blocks.back().get();
+            freeSize = BlockSize;
+        }
+        destination = nextFree;
+        nextFree += size;
+        freeSize -= size;
+    }
+
+    std::memcpy(destination, str.data(), str.size());
+    destination[str.size()] = '\0';
+    return destination;
+}
+
+std::size_t StringPool::findSlot(std::string_view str) const
+{
+    // There's always at least one empty slot, so this stops
+    std::size_t mask = slots.size() - 1;
+    std::size_t slot = std::hash<std::string_view>()(str) & mask;
+    while (slots[slot] != EmptySlot && strings[slots[slot]] != str)
+        slot = (slot + 1) & mask;
+    return slot;
+}
+
+void StringPool::growSlots()
+{
+    // A power of 2, so a hash is turned into a slot with a mask
+    slots.assign(std::max(MinSlots, slots.size() * 2), EmptySlot);
+    for (StringId id = 0; id < strings.size(); id++)
+        slots[findSlot(strings[id])] = id;
+}
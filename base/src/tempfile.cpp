@@ -0,0 +1,28 @@
+#include "viszbase/tempfile.hpp"
+
+#include <charconv>
+#include <cstdint>
+#include <random>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+std::string getTempPath(const std::string& path)
+{
+#ifdef _WIN32
+    std::uint64_t pid = _getpid();
+#else
+    std::uint64_t pid = getpid();
+#endif
+    std::random_device device;
+    std::uint64_t random = (std::uint64_t(device()) << 32) | device();
+
+    char name[48];
+    char* end = std::to_chars(name, name + 16, pid, 16).ptr;
+    *end++ = '-';
+    end = std::to_chars(end, end + 16, random, 16).ptr;
+    return path + '.' + std::string(name, end) + ".tmp";
+}
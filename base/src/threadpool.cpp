@@ -0,0 +1,124 @@
+#include "viszbase/threadpool.hpp"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned threads)
+    : threadCount{(threads != 0)
+                      ? threads
+                      : std::max(1u, std::thread::hardware_concurrency())}
+{
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (auto& worker : workers)
+        worker.join();
+}
+
+void ThreadPool::run(std::size_t runCount,
+                     const std::function<void(std::size_t)>& runTask)
+{
+    // Not worth waking the workers up
+    if (threadCount <= 1 || runCount <= 1)
+    {
+        for (std::size_t i = 0; i < runCount; i++)
+            runTask(i);
+        return;
+    }
+
+    // The calling thread does work too, so start one less
+    if (workers.empty())
+        for (unsigned i = 1; i < threadCount; i++)
+            workers.emplace_back(&ThreadPool::workerLoop, this);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        task = &runTask;
+        count = runCount;
+        next = 0;
+        finished = 0;
+        error = nullptr;
+        ++generation;
+    }
+    wake.notify_all();
+
+    // Help out rather than sit idle
+    work(runTask, runCount);
+
+    // Wait for every task to finish, and for every worker to have left this
+    // run, so that none of them see the state of the next run half set up
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock,
+              [&]() { return finished == count && activeWorkers == 0; });
+    task = nullptr;
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+void ThreadPool::workerLoop()
+{
+    unsigned seenGeneration = 0;
+    while (true)
+    {
+        const std::function<void(std::size_t)>* runTask;
+        std::size_t runCount;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&]()
+                      { return stopping || generation != seenGeneration; });
+            if (stopping)
+                return;
+
+            seenGeneration = generation;
+            // The run may already be over, in which case there's nothing to
+            // do until the next one
+            if (task == nullptr)
+                continue;
+
+            runTask = task;
+            runCount = count;
+            ++activeWorkers;
+        }
+
+        work(*runTask, runCount);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --activeWorkers;
+        }
+        done.notify_all();
+    }
+}
+
+void ThreadPool::work(const std::function<void(std::size_t)>& runTask,
+                      std::size_t runCount)
+{
+    // Take indices until none are left
+    for (std::size_t i = next++; i < runCount; i = next++)
+    {
+        try
+        {
+            runTask(i);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error)
+                error = std::current_exception();
+        }
+
+        if (++finished == runCount)
+        {
+            // Lock so the notification can't slip in before run() waits
+            std::lock_guard<std::mutex> lock(mutex);
+            done.notify_all();
+        }
+    }
+}
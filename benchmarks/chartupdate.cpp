@@ -0,0 +1,76 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "barchart.hpp"
+
+// Times BarChart::update, which is run every frame, on generated files with
+// more and more rows, to show how it scales. Also times loading each file,
+// which includes building the bar chart's rank timeline, and counts how many
+// times bars swap places. Usage:
+// numvisz_bench_chartupdate [categories] [frames] [bars shown]
+int main(int argc, char** argv)
+{
+    int categories = (argc > 1) ? std::stoi(argv[1]) : 20;
+    int frames = (argc > 2) ? std::stoi(argv[2]) : 200;
+    int barsShown = (argc > 3) ? std::stoi(argv[3]) : 20;
+
+    const Timer::FloatMS timePerCategory(1000);
+    auto path =
+        std::filesystem::temp_directory_path() / "numvisz_chartupdate.csv";
+
+    for (int rows : {1000, 2000, 5000, 10000, 20000, 50000, 100000, 500000})
+    {
+        // Each row wanders up and down, so the bars keep changing places
+        std::mt19937 random(1);
+        {
+            std::ofstream csv(path, std::ios::binary);
+            csv << "Title";
+            for (int c = 0; c < categories; c++)
+                csv << ",Category " << c;
+            csv << '\n';
+            for (int r = 0; r < rows; r++)
+            {
+                csv << "Row " << r;
+                long value = random() % 100000;
+                for (int c = 0; c < categories; c++)
+                {
+                    value = std::max(0l, value + long(random() % 20001) -
+                                             10000);
+                    csv << ',' << value;
+                }
+                csv << '\n';
+            }
+        }
+
+        CsvOptions options;
+        options.cache = CacheMode::Off;
+        auto start = std::chrono::steady_clock::now();
+        BarChart chart(path.string(), options, timePerCategory, 20);
+        std::chrono::duration<double, std::milli> loadTime =
+            std::chrono::steady_clock::now() - start;
+
+        // Step through the whole of the time line over the frames
+        start = std::chrono::steady_clock::now();
+        std::size_t swaps = 0;
+        for (int f = 0; f < frames; f++)
+        {
+            chart.update(timePerCategory * (categories - 1) * f / frames, 10,
+                         barsShown);
+            swaps += chart.getRankSwaps();
+        }
+        std::chrono::duration<double, std::milli> time =
+            std::chrono::steady_clock::now() - start;
+
+        std::cout << rows << " rows: load " << loadTime.count() << " ms, "
+                  << time.count() / frames << " ms per frame, "
+                  << double(swaps) / frames << " swaps per frame"
+                  << std::endl;
+    }
+
+    std::filesystem::remove(path);
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <algorithm>
+
+#include "viszbase/csvparser.hpp"
+
+// Parses the given CSV file with each of the parser's modes and reports the
+// throughput of each. The cached mode leaves a cache file next to the CSV
+// file. Usage: numvisz_bench_csvload <file.csv> [iterations]
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <file.csv> [iterations]"
+                  << std::endl;
+        return -1;
+    }
+    const std::string fileName = argv[1];
+    int iterations = (argc > 2) ? std::stoi(argv[2]) : 3;
+
+    double megabytes = std::filesystem::file_size(fileName) / 1e6;
+
+    unsigned hardwareThreads =
+        std::max(1u, std::thread::hardware_concurrency());
+
+    auto makeOptions = [](bool memoryMap, unsigned threads, CacheMode cache)
+    {
+        CsvOptions options;
+        options.memoryMap = memoryMap;
+        options.threads = threads;
+        options.cache = cache;
+        return options;
+    };
+
+    struct
+    {
+        std::string name;
+        CsvOptions options;
+    } modes[] = {
+        {"read, 1 thread", makeOptions(false, 1, CacheMode::Off)},
+        {"mapped, 1 thread", makeOptions(true, 1, CacheMode::Off)},
+        {"mapped, " + std::to_string(hardwareThreads) + " threads",
+         makeOptions(true, hardwareThreads, CacheMode::Off)},
+        // Written by the first run, then loaded by the rest
+        {"cached", makeOptions(true, hardwareThreads, CacheMode::On)},
+    };
+
+    for (auto& mode : modes)
+    {
+        // Take the best of the runs, so the page cache is warm for each mode
+        double best = 0;
+        for (int i = 0; i < iterations; i++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            CsvParser parser(fileName, mode.options);
+            std::chrono::duration<double> seconds =
+                std::chrono::steady_clock::now() - start;
+
+            best = std::max(best, megabytes / seconds.count());
+        }
+        std::cout << mode.name << ": " << best << " MB/s" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "viszbase/csvparser.hpp"
+#include "viszbase/csvscanner.hpp"
+
+// Compares the scalar and SIMD CSV scanners on a wide generated file, both
+// finding every cell on its own and as part of a full parse. Usage:
+// numvisz_bench_csvscan [columns] [rows]
+int main(int argc, char** argv)
+{
+    int columns = (argc > 1) ? std::stoi(argv[1]) : 20000;
+    int rows = (argc > 2) ? std::stoi(argv[2]) : 200;
+
+    // Generate the file, with some quoted cells thrown in
+    std::mt19937 random(1);
+    std::string csv = "Title";
+    for (int c = 0; c < columns; c++)
+        csv += ",Category " + std::to_string(c);
+    csv += '\n';
+    for (int r = 0; r < rows; r++)
+    {
+        csv += "Row " + std::to_string(r);
+        for (int c = 0; c < columns; c++)
+        {
+            std::string value = std::to_string(random() % 100000);
+            csv += (random() % 10 == 0) ? ",\"" + value + "\"" : "," + value;
+        }
+        csv += '\n';
+    }
+    double megabytes = csv.size() / 1e6;
+
+    auto path = std::filesystem::temp_directory_path() / "numvisz_csvscan.csv";
+    std::ofstream(path, std::ios::binary) << csv;
+
+    std::cout << columns << " columns, " << rows << " rows, " << megabytes
+              << " MB" << std::endl;
+
+    const struct
+    {
+        const char* name;
+        CsvScannerKind kind;
+    } kinds[] = {
+        {"scalar", CsvScannerKind::Scalar},
+        {"sse2", CsvScannerKind::SSE2},
+        {"avx2", CsvScannerKind::AVX2},
+    };
+
+    for (auto& kind : kinds)
+    {
+        if (!CsvScanner::isSupported(kind.kind))
+        {
+            std::cout << kind.name << ": not supported" << std::endl;
+            continue;
+        }
+
+        // Walk every cell, skipping quoted cells the same way the parser does
+        auto start = std::chrono::steady_clock::now();
+        CsvScanner scanner(csv, kind.kind);
+        std::size_t cells = 0;
+        for (std::size_t pos = 0; pos < csv.size(); ++cells)
+        {
+            if (csv[pos] == '"')
+                pos = scanner.findQuote(pos + 1) + 2;
+            else
+                pos = scanner.findSeparator(pos) + 1;
+        }
+        std::chrono::duration<double> scanTime =
+            std::chrono::steady_clock::now() - start;
+
+        // Then parse the whole file on one thread
+        start = std::chrono::steady_clock::now();
+        CsvOptions options;
+        options.threads = 1;
+        options.scanner = kind.kind;
+        CsvParser parser(path.string(), options);
+        std::chrono::duration<double> parseTime =
+            std::chrono::steady_clock::now() - start;
+
+        std::cout << kind.name << ": scan " << megabytes / scanTime.count()
+                  << " MB/s (" << cells << " cells), parse "
+                  << megabytes / parseTime.count() << " MB/s" << std::endl;
+    }
+
+    std::filesystem::remove(path);
+    return 0;
+}
@@ -0,0 +1,127 @@
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "glad/gl.hpp"
+#include "viszbase/fontrenderer.hpp"
+#include "viszbase/cachedirectory.hpp"
+#include "viszbase/gui.hpp"
+
+namespace
+{
+void appendUtf8(std::string& str, char32_t c)
+{
+    if (c < 0x80)
+        str += char(c);
+    else if (c < 0x800)
+    {
+        str += char(0xc0 | (c >> 6));
+        str += char(0x80 | (c & 0x3f));
+    }
+    else
+    {
+        str += char(0xe0 | (c >> 12));
+        str += char(0x80 | ((c >> 6) & 0x3f));
+        str += char(0x80 | (c & 0x3f));
+    }
+}
+
+// Labels using every character in the ranges, 40 to a label
+std::vector<std::string> makeLabels()
+{
+    // ASCII, Latin-1 and Latin Extended-A, then some CJK
+    const char32_t ranges[][2] = {
+        {0x21, 0x7e}, {0xa1, 0x17f}, {0x4e00, 0x4e00 + 400}};
+    std::vector<std::string> labels(1);
+    int inLabel = 0;
+    for (const auto& range : ranges)
+    {
+        for (char32_t c = range[0]; c <= range[1]; c++)
+        {
+            appendUtf8(labels.back(), c);
+            if (++inLabel == 40)
+            {
+                labels.emplace_back();
+                inLabel = 0;
+            }
+        }
+    }
+    return labels;
+}
+
+void removeGlyphCaches()
+{
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(
+             getCacheDirectory(), error))
+        if (entry.path().extension() == ".nvzglyphs")
+            std::filesystem::remove(entry.path(), error);
+}
+
+// Loads the font at the line chart's three sizes and draws every label in
+// each, returning the time taken until the GPU has finished drawing them.
+// The glyphs are saved to the cache afterwards, which isn't timed
+double drawFirstFrame(const std::string& fontFile, GlyphMode mode,
+                      const std::vector<std::string>& labels)
+{
+    math::Matrix<4, 4> projection;
+    math::setOrtho(projection, 0, 800, 600, 0, -0.1f, -100.0f);
+
+    auto start = std::chrono::steady_clock::now();
+    FontRenderer renderers[3];
+    const int sizes[3] = {10, 16, 24};
+    for (int i = 0; i < 3; i++)
+    {
+        renderers[i].loadFont(fontFile, sizes[i], mode);
+        for (std::size_t l = 0; l < labels.size(); l++)
+            renderers[i].queueMsg(0, l * 10, labels[l]);
+        renderers[i].flush(projection);
+    }
+    glFinish();
+    std::chrono::duration<double, std::milli> time =
+        std::chrono::steady_clock::now() - start;
+    return time.count();
+}
+} // namespace
+
+// Times loading fonts and drawing the first frame of text with an empty
+// glyph cache, where every glyph has to be rendered, against loading them
+// from the cache the empty run wrote. Glyph cache files already there are
+// removed before each cold run. Usage:
+// numvisz_bench_fontstartup <font file> [bitmap or sdf] [runs]
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: numvisz_bench_fontstartup <font file> "
+                     "[bitmap or sdf] [runs]"
+                  << std::endl;
+        return 1;
+    }
+    std::string fontFile = argv[1];
+    bool sdf = argc > 2 && std::string(argv[2]) == "sdf";
+    GlyphMode mode = sdf ? GlyphMode::Sdf : GlyphMode::Bitmap;
+    int runs = (argc > 3) ? std::stoi(argv[3]) : 5;
+
+    GUI gui;
+    gui.setup(800, 600, "numvisz_bench_fontstartup");
+    std::vector<std::string> labels = makeLabels();
+
+    double coldTotal = 0, cachedTotal = 0;
+    for (int run = 0; run < runs; run++)
+    {
+        removeGlyphCaches();
+        double cold = drawFirstFrame(fontFile, mode, labels);
+        double cached = drawFirstFrame(fontFile, mode, labels);
+        std::cout << "run " << run << ": empty cache " << cold
+                  << " ms, from cache " << cached << " ms" << std::endl;
+        coldTotal += cold;
+        cachedTotal += cached;
+    }
+    std::cout << (sdf ? "sdf" : "bitmap") << " average: empty cache "
+              << coldTotal / runs << " ms, from cache " << cachedTotal / runs
+              << " ms" << std::endl;
+    return 0;
+}
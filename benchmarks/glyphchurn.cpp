@@ -0,0 +1,112 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "glad/gl.hpp"
+#include "viszbase/fontrenderer.hpp"
+#include "viszbase/gui.hpp"
+
+namespace
+{
+void appendUtf8(std::string& str, char32_t c)
+{
+    if (c < 0x80)
+        str += char(c);
+    else if (c < 0x800)
+    {
+        str += char(0xc0 | (c >> 6));
+        str += char(0x80 | (c & 0x3f));
+    }
+    else
+    {
+        str += char(0xe0 | (c >> 12));
+        str += char(0x80 | ((c >> 6) & 0x3f));
+        str += char(0x80 | (c & 0x3f));
+    }
+}
+
+// The CJK Unified Ideographs block
+constexpr char32_t FirstCjk = 0x4e00;
+constexpr char32_t CjkCount = 0x5200;
+
+constexpr int LabelsPerFrame = 30;
+constexpr int CharactersPerLabel = 8;
+// Characters are picked from this many in a row, which move on by a few
+// each frame
+constexpr char32_t WindowSize = 3000;
+constexpr char32_t WindowStep = 10;
+} // namespace
+
+// Draws frames of labels made of CJK characters, picked from a window that
+// moves on through the CJK block each frame the way the names in a large
+// dataset come and go, along with a few labels that stay the same. Prints
+// the time per frame, the atlas memory and the glyph counters every so
+// often, to show the memory staying the same however many characters have
+// been drawn. Usage:
+// numvisz_bench_glyphchurn <font file> [bitmap or sdf] [frames]
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: numvisz_bench_glyphchurn <font file> "
+                     "[bitmap or sdf] [frames]"
+                  << std::endl;
+        return 1;
+    }
+    std::string fontFile = argv[1];
+    bool sdf = argc > 2 && std::string(argv[2]) == "sdf";
+    int frames = (argc > 3) ? std::stoi(argv[3]) : 2000;
+
+    GUI gui;
+    gui.setup(800, 600, "numvisz_bench_glyphchurn");
+    math::Matrix<4, 4> projection;
+    math::setOrtho(projection, 0, 800, 600, 0, -0.1f, -100.0f);
+
+    FontRenderer renderer;
+    renderer.loadFont(fontFile, 24, sdf ? GlyphMode::Sdf : GlyphMode::Bitmap);
+    const std::string fixedLabels[] = {"Population", "Year", "Total",
+                                       "numvisz"};
+
+    std::mt19937 random(1);
+    std::string label;
+    int timedFrames = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 1; frame <= frames; frame++)
+    {
+        glClear(GL_COLOR_BUFFER_BIT);
+        for (int l = 0; l < LabelsPerFrame; l++)
+        {
+            label.clear();
+            for (int c = 0; c < CharactersPerLabel; c++)
+            {
+                char32_t offset = frame * WindowStep + random() % WindowSize;
+                appendUtf8(label, FirstCjk + offset % CjkCount);
+            }
+            renderer.queueMsg(10, l * 20, label);
+        }
+        for (int l = 0; l < 4; l++)
+            renderer.queueMsg(400, l * 20, fixedLabels[l]);
+        renderer.flush(projection);
+        FontRenderer::endFrame();
+
+        timedFrames++;
+        if (frame % 250 == 0 || frame == frames)
+        {
+            glFinish();
+            std::chrono::duration<double, std::milli> time =
+                std::chrono::steady_clock::now() - start;
+            FontRenderer::GlyphStats stats = renderer.getGlyphStats();
+            std::cout << "frame " << frame << ": "
+                      << time.count() / timedFrames << " ms per frame, "
+                      << stats.pageCount << " pages, "
+                      << stats.memoryUsage / 1024 << " KiB, " << stats.hits
+                      << " hits, " << stats.misses << " misses, "
+                      << stats.evictions << " evictions" << std::endl;
+            timedFrames = 0;
+            start = std::chrono::steady_clock::now();
+        }
+    }
+    return 0;
+}
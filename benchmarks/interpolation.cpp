@@ -0,0 +1,85 @@
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "viszbase/interpolation.hpp"
+
+namespace
+{
+// Interpolates 'rows' random values 'repeats' times with each kind, checking
+// they all give the same values, lowest and highest as the scalar version
+template <typename T>
+void run(const char* typeName, std::size_t rows, int repeats)
+{
+    std::mt19937 random(1);
+    std::uniform_real_distribution<T> distribution(-1e6, 1e6);
+    std::vector<T> from(rows), to(rows);
+    for (std::size_t r = 0; r < rows; r++)
+    {
+        from[r] = distribution(random);
+        to[r] = distribution(random);
+    }
+
+    std::vector<T> expected(rows), out(rows);
+    ValueRange<T> expectedRange =
+        interpolate(from.data(), to.data(), T(0.37), expected.data(), rows,
+                    InterpolationKind::Scalar);
+
+    const struct
+    {
+        const char* name;
+        InterpolationKind kind;
+    } kinds[] = {
+        {"scalar", InterpolationKind::Scalar},
+        {"sse2", InterpolationKind::SSE2},
+        {"avx2", InterpolationKind::AVX2},
+    };
+
+    for (auto& kind : kinds)
+    {
+        if (!isInterpolationSupported(kind.kind))
+        {
+            std::cout << typeName << " " << kind.name << ": not supported"
+                      << std::endl;
+            continue;
+        }
+
+        ValueRange<T> range = interpolate(from.data(), to.data(), T(0.37),
+                                          out.data(), rows, kind.kind);
+        bool same = range.lowest == expectedRange.lowest &&
+                    range.highest == expectedRange.highest &&
+                    std::memcmp(out.data(), expected.data(),
+                                rows * sizeof(T)) == 0;
+
+        // Move through a category over the repeats, like the frames do
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < repeats; i++)
+            range = interpolate(from.data(), to.data(), T(i) / repeats,
+                                out.data(), rows, kind.kind);
+        std::chrono::duration<double, std::milli> time =
+            std::chrono::steady_clock::now() - start;
+
+        std::cout << typeName << " " << kind.name << ": "
+                  << time.count() / repeats << " ms per call, "
+                  << (same ? "same as scalar" : "DIFFERENT from scalar")
+                  << std::endl;
+    }
+}
+} // namespace
+
+// Times interpolating every row's value between 2 categories, along with
+// finding the lowest and highest, as the line chart does every frame. Usage:
+// numvisz_bench_interpolation [rows] [repeats]
+int main(int argc, char** argv)
+{
+    std::size_t rows = (argc > 1) ? std::stoul(argv[1]) : 1000000;
+    int repeats = (argc > 2) ? std::stoi(argv[2]) : 200;
+
+    std::cout << rows << " rows" << std::endl;
+    run<float>("float", rows, repeats);
+    run<double>("double", rows, repeats);
+    return 0;
+}
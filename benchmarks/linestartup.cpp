@@ -0,0 +1,49 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "glad/gl.hpp"
+#include "viszbase/gui.hpp"
+#include "viszbase/linerenderer.hpp"
+
+// Times making a line renderer for each row of a line chart, as happens
+// before the first frame, then drawing them all once. Usage:
+// numvisz_bench_linestartup [rows] [points per line]
+int main(int argc, char** argv)
+{
+    int rows = (argc > 1) ? std::stoi(argv[1]) : 2000;
+    int points = (argc > 2) ? std::stoi(argv[2]) : 50;
+
+    GUI gui;
+    gui.setup(800, 600, "numvisz_bench_linestartup");
+    math::Matrix<4, 4> projection;
+    math::setOrtho(projection, 0, 800, 600, 0, -0.1f, -100.0f);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<LineRenderer> lines;
+    lines.reserve(rows);
+    for (int r = 0; r < rows; r++)
+    {
+        LineRendererBuilder builder;
+        for (int p = 0; p < points; p++)
+            builder.addPoint(p * 800.0f / points,
+                             300 + 200 * std::sin(p * 0.1f + r));
+        lines.push_back(builder.build());
+    }
+    glFinish();
+    std::chrono::duration<double, std::milli> buildTime =
+        std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (LineRenderer& line : lines)
+        line.draw({0.1f, 0.1f, 0.8f, 1.0f}, 800.0f / 600.0f, 2, projection);
+    glFinish();
+    std::chrono::duration<double, std::milli> drawTime =
+        std::chrono::steady_clock::now() - start;
+
+    std::cout << rows << " lines: made in " << buildTime.count()
+              << " ms, drawn in " << drawTime.count() << " ms" << std::endl;
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "glad/gl.hpp"
+#include "viszbase/cachedirectory.hpp"
+#include "viszbase/gui.hpp"
+#include "viszbase/programcache.hpp"
+#include "viszbase/shader.hpp"
+
+namespace
+{
+void removeProgramCaches()
+{
+    std::error_code error;
+    for (const auto& entry :
+         std::filesystem::directory_iterator(getCacheDirectory(), error))
+        if (entry.path().extension() == ".nvzprogram")
+            std::filesystem::remove(entry.path(), error);
+}
+
+// Makes every program the charts use and draws once with each, as happens
+// before the first frame, returning the time taken until the GPU has
+// finished
+double makePrograms()
+{
+    unsigned VAO;
+    glGenVertexArrays(1, &VAO);
+    glBindVertexArray(VAO);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::unique_ptr<Shader>> shaders;
+    shaders.push_back(std::make_unique<Shader>(
+#include "shaders/rect.vs"
+        ,
+#include "shaders/rect.fs"
+        ));
+    shaders.push_back(std::make_unique<Shader>(
+#include "shaders/font.vs"
+        ,
+#include "shaders/font.fs"
+        ));
+    shaders.push_back(std::make_unique<Shader>(
+#include "shaders/font.vs"
+        ,
+#include "shaders/fontsdf.fs"
+        ));
+    shaders.push_back(std::make_unique<Shader>(
+#include "shaders/line.vs"
+        ,
+#include "shaders/line.gs"
+        ,
+#include "shaders/line.fs"
+        ));
+    for (const auto& shader : shaders)
+        if (!shader->getErrorMsg().empty())
+            throw std::runtime_error("Shader error: " +
+                                     shader->getErrorMsg());
+
+    // Some drivers only finish building a program when it's first drawn
+    // with
+    for (std::size_t s = 0; s < shaders.size(); s++)
+    {
+        glUseProgram(shaders[s]->getProgram());
+        if (s + 1 == shaders.size())
+            glDrawArrays(GL_LINE_STRIP_ADJACENCY, 0, 4);
+        else
+            glDrawArrays(GL_TRIANGLES, 0, 6);
+    }
+    glFinish();
+    std::chrono::duration<double, std::milli> time =
+        std::chrono::steady_clock::now() - start;
+
+    shaders.clear();
+    glDeleteVertexArrays(1, &VAO);
+    return time.count();
+}
+} // namespace
+
+// Times making the shader programs and drawing with each once, compiling
+// them from source with the program cache turned off, against loading the
+// binaries the cache saved. Drivers keep what they've compiled for the rest
+// of the process, so each is timed in a new process, running this again
+// with 'compiled' or 'cached'. Program cache files already there are
+// removed first. Usage:
+// numvisz_bench_shaderstartup [runs]
+int main(int argc, char** argv)
+{
+    std::string mode = (argc > 1) ? argv[1] : "";
+    if (mode == "compiled" || mode == "cached" || mode == "fill")
+    {
+        GUI gui;
+        gui.setup(800, 600, "numvisz_bench_shaderstartup");
+        if (!ProgramCache::isAvailable())
+        {
+            std::cerr << "The driver can't hand out program binaries"
+                      << std::endl;
+            return 1;
+        }
+        ProgramCache::setEnabled(mode != "compiled");
+        double time = makePrograms();
+        if (mode != "fill")
+            std::cout << mode << " " << time << " ms" << std::endl;
+        return 0;
+    }
+
+    int runs = (argc > 1) ? std::stoi(argv[1]) : 5;
+    std::string command = '"' + std::string(argv[0]) + '"';
+    removeProgramCaches();
+    if (std::system((command + " fill").c_str()) != 0)
+        return 1;
+    for (int run = 0; run < runs; run++)
+    {
+        std::system((command + " compiled").c_str());
+        std::system((command + " cached").c_str());
+    }
+    return 0;
+}
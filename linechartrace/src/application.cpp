@@ -46,12 +46,14 @@ int Application::run()
     const std::string& fontName = args.get("-font");
     if (fontName == Arguments::NotSet)
         throw std::runtime_error("Font file not provided");
-    fontRendererSmall.loadFont(fontName, 10);
-    fontRenderer.loadFont(fontName, 16);
-    fontRendererLarge.loadFont(fontName, 24);
+    GlyphMode fontMode = glyphModeFromArguments(args);
+    fontRendererSmall.loadFont(fontName, 10, fontMode);
+    fontRenderer.loadFont(fontName, 16, fontMode);
+    fontRendererLarge.loadFont(fontName, 24, fontMode);
 
     // Setup line chart race
-    LineChart lineChart(fileName, timePerCategory, lineThickness);
+    LineChart lineChart(fileName, CsvOptions::fromArguments(args),
+                        timePerCategory, lineThickness);
 
     // Padding and Spacing values
     struct
@@ -94,6 +96,17 @@ int Application::run()
     {
         gui.clearScreen(Color{1.0f, 1.0f, 1.0f, 1.0f});
 
+        // Take in anything added to the CSV file if following it, and make
+        // room for any longer row names
+        if (lineChart.followFile())
+        {
+            newSpacingAfterLines =
+                fontRenderer.getWidthOfMsg(lineChart.getLongestRowName()) +
+                Paddings.afterLines;
+            if (Spacings.afterLines < newSpacingAfterLines)
+                Spacings.afterLines = newSpacingAfterLines;
+        }
+
         // Update state of line chart
         lineChart.update(timer.getInMilliseconds());
 
@@ -157,14 +170,16 @@ int Application::run()
                       percentAcrossLine * (gui.width - Spacings.beforeLines -
                                            Spacings.afterLines);
 
-            fontRenderer.drawMsg(
+            fontRenderer.queueMsg(
                 x, gui.height - Spacings.belowLines + Paddings.belowLines * 0.2,
-                lineChart.getCategories()[i], proj);
+                lineChart.getCategories()[i]);
 
-            renderer.drawBox(x, Spacings.aboveLines, x + 2,
-                             gui.height - Spacings.belowLines,
-                             Color{0, 0, 0, 0.1f}, proj);
+            renderer.queueBox(x, Spacings.aboveLines, x + 2,
+                              gui.height - Spacings.belowLines,
+                              Color{0, 0, 0, 0.1f});
         }
+        renderer.flush(proj);
+        fontRenderer.flush(proj);
 
         // Set projection
         math::setOrtho(proj, highestValue + (height * (lineThickness / 2)),
@@ -177,14 +192,8 @@ int Application::run()
                         gui.height - Spacings.aboveLines - Spacings.belowLines);
         // Draw the lines in the order they appear in the CSV
         float aspectRatio = float(gui.width) / gui.height;
-        for (auto& row : lineChart.getRows())
-        {
-            auto line =
-                std::find_if(lineChart.getLineStates().begin(),
-                             lineChart.getLineStates().end(),
-                             [&](const auto& l) { return l.name == row.name; });
-            line->renderer.draw(line->color, aspectRatio, lineThickness, proj);
-        }
+        for (auto& line : lineChart.getLineStates())
+            line.renderer.draw(line.color, aspectRatio, lineThickness, proj);
 
         // Reset viewport and projection
         gui.setViewport(0, 0, gui.width, gui.height);
@@ -192,76 +201,82 @@ int Application::run()
 
         // Draw frame around lines
         // Draw line along side
-        renderer.drawBox(
-            Spacings.beforeLines, Spacings.aboveLines, Spacings.beforeLines + 1,
-            gui.height - Spacings.belowLines, Color{0, 0, 0, 1}, proj);
+        renderer.queueBox(Spacings.beforeLines, Spacings.aboveLines,
+                          Spacings.beforeLines + 1,
+                          gui.height - Spacings.belowLines, Color{0, 0, 0, 1});
         // Draw line along top
-        renderer.drawBox(Spacings.beforeLines, Spacings.aboveLines,
-                         gui.width - Spacings.afterLines,
-                         Spacings.aboveLines + 1, Color{0, 0, 0, 1}, proj);
+        renderer.queueBox(Spacings.beforeLines, Spacings.aboveLines,
+                          gui.width - Spacings.afterLines,
+                          Spacings.aboveLines + 1, Color{0, 0, 0, 1});
         // Draw line along bottom
-        renderer.drawBox(Spacings.beforeLines, gui.height - Spacings.belowLines,
-                         gui.width - Spacings.afterLines,
-                         gui.height - Spacings.belowLines + 1,
-                         Color{0, 0, 0, 1}, proj);
+        renderer.queueBox(Spacings.beforeLines,
+                          gui.height - Spacings.belowLines,
+                          gui.width - Spacings.afterLines,
+                          gui.height - Spacings.belowLines + 1,
+                          Color{0, 0, 0, 1});
+        renderer.flush(proj);
 
         // Draw text
         // Draw title
         fontRendererLarge.drawMsg(Spacings.beforeLines,
                                   Paddings.aboveLines / 2.0,
                                   lineChart.getName(), proj);
-        // Draw row names and values next to lines
+        // Draw row names and values next to lines, from the highest down
         float nextAvailableY = 0.0f;
-        for (auto& line : lineChart.getLineStates())
+        for (std::size_t r : lineChart.getRanking())
         {
+            const LineChart::Line& line = lineChart.getLineStates()[r];
+            Value currentValue = lineChart.getCurrentValues()[r];
             float textY =
                 Spacings.aboveLines - fontRenderer.getFontHeight() * 0.5 +
-                (1 - (line.currentValue - lowestValue) / height) *
+                (1 - (currentValue - lowestValue) / height) *
                     (gui.height - Spacings.aboveLines - Spacings.belowLines);
             if (textY < nextAvailableY)
                 textY = nextAvailableY;
 
-            fontRenderer.drawMsg(gui.width - Spacings.afterLines +
-                                     Paddings.afterLines * 0.2,
-                                 textY, line.name, proj);
-            fontRenderer.drawLongDouble(
+            fontRenderer.queueMsg(gui.width - Spacings.afterLines +
+                                      Paddings.afterLines * 0.2,
+                                  textY, line.name);
+            fontRenderer.queueLongDouble(
                 gui.width - Spacings.afterLines + Paddings.afterLines * 0.2,
-                textY + fontRenderer.getFontHeight() * 0.8, line.currentValue,
-                numOfDecimalPlaces, proj);
+                textY + fontRenderer.getFontHeight() * 0.8, currentValue,
+                numOfDecimalPlaces);
 
             nextAvailableY = textY + textPanelHeight;
         }
+        fontRenderer.flush(proj);
 
-        // Draw the highest and lowest values along the left side
-        fontRendererSmall.drawLongDouble(
-            Spacings.beforeLines - Paddings.beforeLines * 0.5 -
-                fontRendererSmall.getWidthOfLongDouble(highestValue,
-                                                       numOfDecimalPlaces),
-            Spacings.aboveLines - (fontRendererSmall.getFontHeight() * 0.5),
-            highestValue, numOfDecimalPlaces, proj);
-        fontRendererSmall.drawLongDouble(
-            Spacings.beforeLines - Paddings.beforeLines * 0.5 -
-                fontRendererSmall.getWidthOfLongDouble(lowestValue,
-                                                       numOfDecimalPlaces),
-            gui.height - Spacings.belowLines -
-                (fontRendererSmall.getFontHeight() * 0.5),
-            lowestValue, numOfDecimalPlaces, proj);
+        // Draw the highest and lowest values along the left side, each
+        // formatted once for both measuring and drawing it
+        float valuesX2 = Spacings.beforeLines - Paddings.beforeLines * 0.5;
+        auto queueValue = [&](long double value, int decimalPoints, float y)
+        {
+            const FontRenderer::TextRun& run =
+                fontRendererSmall.getNumberRun(value, decimalPoints);
+            fontRendererSmall.queueRun(valuesX2 - run.getWidth(), y, run);
+        };
+        queueValue(highestValue, numOfDecimalPlaces,
+                   Spacings.aboveLines -
+                       (fontRendererSmall.getFontHeight() * 0.5));
+        queueValue(lowestValue, numOfDecimalPlaces,
+                   gui.height - Spacings.belowLines -
+                       (fontRendererSmall.getFontHeight() * 0.5));
 
         // If highest value > 0, and lowest value < 0, draw the 0
         if (highestValue > 0 && lowestValue < 0)
         {
-            fontRendererSmall.drawLongDouble(
-                Spacings.beforeLines - Paddings.beforeLines * 0.5 -
-                    fontRendererSmall.getWidthOfLongDouble(0, 0),
-                Spacings.aboveLines - fontRendererSmall.getFontHeight() * 0.5 +
-                    (1 - (-lowestValue / height)) *
-                        (gui.height - Spacings.aboveLines -
-                         Spacings.belowLines),
-                0, 0, proj);
+            queueValue(0, 0,
+                       Spacings.aboveLines -
+                           fontRendererSmall.getFontHeight() * 0.5 +
+                           (1 - (-lowestValue / height)) *
+                               (gui.height - Spacings.aboveLines -
+                                Spacings.belowLines));
         }
+        fontRendererSmall.flush(proj);
 
         // Advance to the next frame
         gui.nextFrame();
+        FontRenderer::endFrame();
     }
     return 0;
 }
@@ -1,53 +1,151 @@
 #include "linechart.hpp"
 
-// Helper function to generate colors for each row
-static void generateColors(std::vector<LineChart::Line>& lines)
+#include <numeric>
+#include <unordered_map>
+
+#include "viszbase/ranking.hpp"
+
+// Helper function to generate colors for 'count' lines, spread out evenly
+// over the range of colors. There may be fewer than 'count' of them, in
+// which case the lines left over keep the color they have
+static std::vector<Color> generateColors(std::size_t count)
 {
-    int i = 0;
-    int increment = 3 * (255.0 / lines.size());
+    std::vector<Color> colors;
+    int increment = 3 * (255.0 / count);
     for (int r = 0; r <= 255; r += increment)
     {
         for (int g = 0; g <= 255; g += increment)
         {
             for (int b = 0; b <= 255; b += increment)
             {
-                if (i < lines.size())
-                    lines[i].color =
-                        Color{r / 255.0f, g / 255.0f, b / 255.0f, 1.0f};
-                else
-                    return;
-                ++i;
+                if (colors.size() >= count)
+                    return colors;
+                colors.push_back(
+                    Color{r / 255.0f, g / 255.0f, b / 255.0f, 1.0f});
             }
         }
     }
+    return colors;
+}
+
+// With fewer rows than this for each thread, spreading an update over
+// threads costs more than it saves
+constexpr std::size_t MinRowsPerThread = 1 << 16;
+
+// The current values are updated a category at a time, so keep the values
+// of each category together
+static CsvOptions withCategoryMajor(CsvOptions options)
+{
+    options.layout = DatasetLayout::CategoryMajor;
+    return options;
 }
 
-LineChart::LineChart(const std::string& csvName, Timer::FloatMS tPC, int lT)
-    : parser(csvName), timePerCategory(tPC), lineThickness(lT)
+LineChart::LineChart(const std::string& csvName, const CsvOptions& csvOptions,
+                     Timer::FloatMS tPC, int lT)
+    : parser(csvName, withCategoryMajor(csvOptions)), timePerCategory(tPC),
+      lineThickness(lT), pool(csvOptions.threads),
+      rangeTable(parser.getDataset())
 {
     numCategories = parser.getCategories().size();
 
     // Go through each line, and load in the values
-    for (auto& row : parser.getRows())
+    for (std::size_t r = 0; r < parser.getDataset().getRowCount(); r++)
+    {
+        lineStates.push_back(makeLine(r));
+        ranking.push_back(r);
+    }
+
+    // Generate colours
+    std::vector<Color> colors = generateColors(lineStates.size());
+    for (std::size_t i = 0; i < colors.size(); i++)
+        lineStates[i].color = colors[i];
+}
+
+LineRendererBuilder LineChart::getLineBuilder(std::size_t row)
+{
+    const Dataset& dataset = parser.getDataset();
+    LineRendererBuilder builder;
+
+    float x = 0.0f;
+    for (std::size_t c = 0; c < dataset.getCategoryCount(); c++)
     {
-        LineRendererBuilder builder;
+        builder.addPoint(x, dataset.get(row, c));
+        x += timePerCategory.count();
+    }
+    return builder;
+}
+
+LineChart::Line LineChart::makeLine(std::size_t row)
+{
+    std::string_view name = parser.getDataset().getName(row);
 
-        float x = 0.0f;
-        for (const auto& value : row.values)
+    // Update longest row name
+    if (name.size() > longestRowName.size())
+        longestRowName = name;
+
+    return {name, Color{0.1f, 0.1f, 0.8f, 1.0f}, getLineBuilder(row).build()};
+}
+
+bool LineChart::followFile()
+{
+    const Dataset& dataset = parser.getDataset();
+    std::vector<std::size_t> newRows;
+
+    switch (parser.update())
+    {
+    case CsvParser::Change::None:
+        return false;
+    case CsvParser::Change::RowsAdded:
+        rangeTable.addRows(dataset, lineStates.size());
+        for (std::size_t r = lineStates.size(); r < dataset.getRowCount(); r++)
         {
-            builder.addPoint(x, value);
-            x += timePerCategory.count();
+            lineStates.push_back(makeLine(r));
+            ranking.push_back(r);
+            newRows.push_back(r);
         }
-        lineStates.push_back(
-            {row.name, Color{0.1f, 0.1f, 0.8f, 1.0f}, builder.build(), 0.0f});
+        break;
+    case CsvParser::Change::Reloaded:
+    {
+        numCategories = parser.getCategories().size();
 
-        // Update longest row name
-        if (row.name.size() > longestRowName.size())
-            longestRowName = row.name;
+        // Keep the lines that are still there, with their colors, and give
+        // them their new points
+        std::unordered_map<std::string_view, Line> previous;
+        for (auto& line : lineStates)
+            previous.emplace(line.name, std::move(line));
+        lineStates.clear();
+        longestRowName = {};
+
+        for (std::size_t r = 0; r < dataset.getRowCount(); r++)
+        {
+            auto found = previous.find(dataset.getName(r));
+            if (found == previous.end())
+            {
+                lineStates.push_back(makeLine(r));
+                newRows.push_back(r);
+                continue;
+            }
+            getLineBuilder(r).rebuild(found->second.renderer);
+            lineStates.push_back(std::move(found->second));
+            lineStates.back().name = dataset.getName(r);
+            if (dataset.getName(r).size() > longestRowName.size())
+                longestRowName = dataset.getName(r);
+        }
+
+        ranking.resize(lineStates.size());
+        std::iota(ranking.begin(), ranking.end(), 0);
+        rangeTable = RangeTable(dataset);
+        break;
+    }
     }
 
-    // Generate colours
-    generateColors(lineStates);
+    // The new lines get the colors after those of the lines already there
+    std::vector<Color> colors = generateColors(lineStates.size());
+    std::size_t kept = lineStates.size() - newRows.size();
+    for (std::size_t i = 0; i < newRows.size() && kept + i < colors.size();
+         i++)
+        lineStates[newRows[i]].color = colors[kept + i];
+    return true;
 }
 
 void LineChart::update(Timer::FloatMS time)
@@ -55,33 +153,68 @@ void LineChart::update(Timer::FloatMS time)
     currentTime = std::min(time, (numCategories - 1) * timePerCategory);
 
     currentPosition = currentTime / timePerCategory;
-    intCurrentPosition = std::min(int(currentPosition), numCategories - 2);
+    intCurrentPosition =
+        std::max(std::min(int(currentPosition), numCategories - 2), 0);
     intNextPosition = std::min(intCurrentPosition + 1, numCategories - 1);
+    currentCategory = int(currentPosition);
+
+    // A big chart is split into parts that are each updated on their own
+    // thread. Every line is worked out on its own, so the parts give exactly
+    // the same results as doing it all at once
+    const Dataset& dataset = parser.getDataset();
+    std::size_t count = dataset.getRowCount();
+    std::size_t parts = std::clamp<std::size_t>(count / MinRowsPerThread, 1,
+                                                pool.getThreadCount());
+
+    // The current value is the previous value plus a fraction of the
+    // difference to the next value, to give the look that we're moving to
+    // the next value gradually as time progresses
+    const Value* prevValues = dataset.getCategory(intCurrentPosition);
+    const Value* nextValues = dataset.getCategory(intNextPosition);
+    currentValues.resize(count);
+    partRanges.resize(parts);
+    pool.run(parts,
+             [&](std::size_t p)
+             {
+                 std::size_t begin = count * p / parts;
+                 std::size_t end = count * (p + 1) / parts;
+                 partRanges[p] = interpolate(
+                     prevValues + begin, nextValues + begin,
+                     Value(currentPosition - intCurrentPosition),
+                     currentValues.data() + begin, end - begin);
+             });
 
-    // Update current values
-    float prevValue, nextValue, diff;
-    for (auto& row : parser.getRows())
+    // Lines with the same value stay in the order they're in the file. The
+    // ranking is already in order from the last frame, so only the lines
+    // that have passed each other need moving
+    reorder(pool, parts, ranking,
+            [&](std::size_t x, std::size_t y)
+            {
+                return currentValues[x] > currentValues[y] ||
+                       (currentValues[x] == currentValues[y] && x < y);
+            });
+
+    // The lines are drawn from the first category up to the current values,
+    // which are between the current category and the next, so the axis has
+    // to fit the values of every category up to the current one and the
+    // current values
+    ValueRange<Value> shown = rangeTable.getRange(intCurrentPosition);
+    for (auto& range : partRanges)
     {
-        prevValue = row.values.at(intCurrentPosition);
-        nextValue = row.values.at(intNextPosition);
-
-        float diff = nextValue - prevValue;
-        // The current value is the previous value plus a fraction of the
-        // difference to the next value, to give the look that we're moving
-        // to the next value gradually as time progresses.
-        float currentValue =
-            prevValue + ((currentPosition - intCurrentPosition) * diff);
-
-        // Update the current value in the lines vector
-        std::find_if(lineStates.begin(), lineStates.end(),
-                     [&](const auto& l) { return l.name == row.name; })
-            ->currentValue = currentValue;
+        shown.lowest = std::min(shown.lowest, range.lowest);
+        shown.highest = std::max(shown.highest, range.highest);
     }
-    std::sort(lineStates.begin(), lineStates.end(),
-              [](const auto& x, const auto& y)
-              { return x.currentValue > y.currentValue; });
+    highestValue = shown.highest;
+    lowestValue = shown.lowest;
 
-    // Update highest and lowest values
-    highestValue = std::max(highestValue, lineStates.front().currentValue);
-    lowestValue = std::min(lowestValue, lineStates.back().currentValue);
+    // The axis is scaled by its height, so when every value shown is the
+    // same, or there aren't any, it's widened to take in 0 and failing that
+    // made 1 high
+    if (!(lowestValue < highestValue))
+    {
+        lowestValue = std::min(lowestValue, 0.0f);
+        highestValue = std::max(highestValue, 0.0f);
+        if (lowestValue == highestValue)
+            highestValue = lowestValue + 1.0f;
+    }
 }
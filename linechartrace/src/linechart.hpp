@@ -3,40 +3,54 @@
 
 #include "viszbase/csvparser.hpp"
 #include "viszbase/color.hpp"
+#include "viszbase/interpolation.hpp"
 #include "viszbase/timer.hpp"
 #include "viszbase/linerenderer.hpp"
+#include "viszbase/rangetable.hpp"
+#include "viszbase/threadpool.hpp"
 
 class LineChart
 {
 public:
-    LineChart(const std::string& csvName, Timer::FloatMS timePerCategory,
-              int lineThickness);
+    LineChart(const std::string& csvName, const CsvOptions& csvOptions,
+              Timer::FloatMS timePerCategory, int lineThickness);
 
     void update(Timer::FloatMS currentTime);
+    // Takes in any changes to the CSV file when it's being followed, returns
+    // true if there were any
+    bool followFile();
     float getLowestValue() { return lowestValue; }
     float getHighestValue() { return highestValue; }
 
     const std::string& getName() { return parser.getName(); }
-    const std::vector<Row>& getRows() { return parser.getRows(); }
-    const std::string& getLongestRowName() { return longestRowName; }
+    std::string_view getLongestRowName() { return longestRowName; }
     float getCurrentPosition() { return currentPosition; }
     int getNextPosition() { return intNextPosition; }
     Timer::FloatMS getCurrentTime() { return currentTime; }
 
     struct Line
     {
-        std::string name;
+        // Points into the dataset
+        std::string_view name;
         Color color;
         LineRenderer renderer;
-        float currentValue;
     };
     const std::vector<std::string>& getCategories()
     {
         return parser.getCategories();
     }
     int getNumCategories() { return numCategories; }
+    // In the same order as the rows of the dataset, so a row's index in the
+    // dataset is its index here
     std::vector<Line>& getLineStates() { return lineStates; }
-    const std::string& getCurrentCategory() { return currentCategory; }
+    // The current value of each line, in the same order as the lines
+    const std::vector<Value>& getCurrentValues() { return currentValues; }
+    // The indices of the lines, from the highest current value to the lowest
+    const std::vector<std::size_t>& getRanking() { return ranking; }
+    const std::string& getCurrentCategory()
+    {
+        return getCategories()[currentCategory];
+    }
 
 private:
     Timer::FloatMS timePerCategory;
@@ -45,14 +59,22 @@ private:
     int numCategories;
 
     std::vector<Line> lineStates;
+    std::vector<Value> currentValues;
+    // The range of the current values in each part of the lines
+    std::vector<ValueRange<Value>> partRanges;
+    std::vector<std::size_t> ranking;
     float currentPosition;
-    std::string currentCategory;
-    std::string longestRowName;
+    std::size_t currentCategory = 0;
+    std::string_view longestRowName;
 
-    float highestValue = std::numeric_limits<float>().min(),
-          lowestValue = std::numeric_limits<float>().max(), height = 0.0f;
+    float highestValue = 0.0f, lowestValue = 0.0f, height = 0.0f;
     int intCurrentPosition = 0, intNextPosition = 0;
     Timer::FloatMS currentTime;
+    ThreadPool pool;
+    RangeTable rangeTable;
+
+    LineRendererBuilder getLineBuilder(std::size_t row);
+    Line makeLine(std::size_t row);
 };
 
 #endif // LINECHART_HPP
@@ -9,9 +9,11 @@ int main(int argc, char** argv)
     try
     {
         // Parse arguments
-        CommandLineParser parser(argc, argv,
-                                 {"-csv", "-font", "-timepercategory",
-                                  "-decimalplaces", "-linethickness"});
+        CommandLineParser parser(
+            argc, argv,
+            {"-csv", "-font", "-timepercategory", "-decimalplaces",
+             "-linethickness", "-decimalseparator", "-thousandsseparator",
+             "-cache", "-follow", "-format", "-categoryorder", "-fontmode"});
         // Start application with those parsed arguments
         Application app(parser.getArguments());
         return app.run();